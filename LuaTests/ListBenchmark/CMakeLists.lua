@@ -0,0 +1,65 @@
+-- Compares passing a large nested source list to a cmake.* function
+-- through the argument wrapper LuaPublicAPIHelper.lua used to install
+-- with calling the function directly, which flattens the table in C.
+-- Run cmake on this directory and compare the printed times.
+cmake.project("ListBenchmark")
+
+local count = 100000
+local sources = {}
+for i = 1, count do
+	sources[i] = "src/file" .. i .. ".c"
+end
+-- nest some of it, as project code often does
+local nested = { "main.c", sources, { "extra1.c", "extra2.c" } }
+local expected = count + 3
+
+-- The wrapper LuaPublicAPIHelper.lua used to install around every
+-- cmake.* function, copied from it.  It flattened the arguments in Lua
+-- and passed the C function one flat array.
+local function recursive_file_concat(big_table, list)
+	if type(list) ~= "table" then
+		table.insert(big_table, list)
+		return list
+	end
+	local res = {}
+	for i=1, #list do
+		res[i] = recursive_file_concat(big_table, list[i])
+	end
+	return res
+end
+
+local function setup_fancy_argument_handling(original_function)
+	local old_function = original_function
+
+	return function(...)
+		local argument_table = {...}
+		local number_of_args = #argument_table
+
+		local flattened_list = {}
+		recursive_file_concat(flattened_list, argument_table)
+
+		return old_function(flattened_list)
+	end
+end
+
+-- Only the call is timed.  Reading the list back is checked outside,
+-- the old helpers had nothing faster than string.split for it.
+local function time(name, variable, func)
+	local start = os.clock()
+	func()
+	local elapsed = os.clock() - start
+	local n = #cmake.vars[variable]
+	print(string.format("-- %-36s %8.3f s  (%d items)", name, elapsed, n))
+	if n ~= expected then
+		error(name .. ": expected " .. expected .. " items, got " .. n)
+	end
+end
+
+local old_set = setup_fancy_argument_handling(cmake.set)
+time("old: flatten in Lua, then in C", "BENCH_OLD", function()
+	old_set("BENCH_OLD", nested)
+end)
+
+time("new: flatten in C only", "BENCH_NEW", function()
+	cmake.set("BENCH_NEW", nested)
+end)
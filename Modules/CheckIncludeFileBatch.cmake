@@ -0,0 +1,94 @@
+# - Check if several include files exist, building all checks at once.
+# CHECK_INCLUDE_FILE_BATCH(INCLUDE VARIABLE [INCLUDE VARIABLE ...])
+# - macro which checks each include file exists.
+#  INCLUDE  - name of include file
+#  VARIABLE - variable to return result
+#
+# This gives the same results as calling CHECK_INCLUDE_FILE for every
+# pair, but the checks whose variable is not set yet are built by one
+# TRY_COMPILE(BATCH ...), which configures a single project and builds
+# the checks in parallel where the make program can.
+#
+# The following variables may be set before calling this macro to
+# modify the way the check is run:
+#
+#  CMAKE_REQUIRED_FLAGS = string of compile command line flags
+#  CMAKE_REQUIRED_DEFINITIONS = list of macros to define (-DFOO=bar)
+#  CMAKE_REQUIRED_INCLUDES = list of include directories
+#
+MACRO(CHECK_INCLUDE_FILE_BATCH)
+  SET(CHECK_INCLUDE_FILE_BATCH_INCLUDE)
+  SET(CHECK_INCLUDE_FILE_BATCH_INCLUDES)
+  SET(CHECK_INCLUDE_FILE_BATCH_VARS)
+  SET(CHECK_INCLUDE_FILE_BATCH_SOURCES)
+  FOREACH(CHECK_INCLUDE_FILE_BATCH_ARG ${ARGN})
+    IF(NOT CHECK_INCLUDE_FILE_BATCH_INCLUDE)
+      SET(CHECK_INCLUDE_FILE_BATCH_INCLUDE ${CHECK_INCLUDE_FILE_BATCH_ARG})
+    ELSE(NOT CHECK_INCLUDE_FILE_BATCH_INCLUDE)
+      IF(NOT DEFINED ${CHECK_INCLUDE_FILE_BATCH_ARG})
+        LIST(LENGTH CHECK_INCLUDE_FILE_BATCH_VARS CHECK_INCLUDE_FILE_BATCH_N)
+        SET(CHECK_INCLUDE_FILE_BATCH_SOURCE
+          ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeTmp/CheckIncludeFileBatch${CHECK_INCLUDE_FILE_BATCH_N}.c)
+        SET(CHECK_INCLUDE_FILE_VAR ${CHECK_INCLUDE_FILE_BATCH_INCLUDE})
+        CONFIGURE_FILE(${CMAKE_ROOT}/Modules/CheckIncludeFile.c.in
+          ${CHECK_INCLUDE_FILE_BATCH_SOURCE} IMMEDIATE)
+        MESSAGE(STATUS "Looking for ${CHECK_INCLUDE_FILE_BATCH_INCLUDE}")
+        LIST(APPEND CHECK_INCLUDE_FILE_BATCH_INCLUDES
+          ${CHECK_INCLUDE_FILE_BATCH_INCLUDE})
+        LIST(APPEND CHECK_INCLUDE_FILE_BATCH_VARS
+          ${CHECK_INCLUDE_FILE_BATCH_ARG})
+        LIST(APPEND CHECK_INCLUDE_FILE_BATCH_SOURCES
+          ${CHECK_INCLUDE_FILE_BATCH_ARG} ${CHECK_INCLUDE_FILE_BATCH_SOURCE})
+      ENDIF(NOT DEFINED ${CHECK_INCLUDE_FILE_BATCH_ARG})
+      SET(CHECK_INCLUDE_FILE_BATCH_INCLUDE)
+    ENDIF(NOT CHECK_INCLUDE_FILE_BATCH_INCLUDE)
+  ENDFOREACH(CHECK_INCLUDE_FILE_BATCH_ARG)
+
+  IF(CHECK_INCLUDE_FILE_BATCH_VARS)
+    IF(CMAKE_REQUIRED_INCLUDES)
+      SET(CHECK_INCLUDE_FILE_BATCH_INCLUDE_DIRS "-DINCLUDE_DIRECTORIES=${CMAKE_REQUIRED_INCLUDES}")
+    ELSE(CMAKE_REQUIRED_INCLUDES)
+      SET(CHECK_INCLUDE_FILE_BATCH_INCLUDE_DIRS)
+    ENDIF(CMAKE_REQUIRED_INCLUDES)
+    SET(MACRO_CHECK_INCLUDE_FILE_BATCH_FLAGS ${CMAKE_REQUIRED_FLAGS})
+
+    TRY_COMPILE(BATCH
+      ${CMAKE_BINARY_DIR}
+      SOURCES ${CHECK_INCLUDE_FILE_BATCH_SOURCES}
+      COMPILE_DEFINITIONS ${CMAKE_REQUIRED_DEFINITIONS}
+      CMAKE_FLAGS
+      -DCOMPILE_DEFINITIONS:STRING=${MACRO_CHECK_INCLUDE_FILE_BATCH_FLAGS}
+      "${CHECK_INCLUDE_FILE_BATCH_INCLUDE_DIRS}"
+      OUTPUT_VARIABLE OUTPUT)
+
+    # The output of the build is shared by all checks, log it once.
+    SET(CHECK_INCLUDE_FILE_BATCH_FAILED)
+    FOREACH(CHECK_INCLUDE_FILE_BATCH_VAR ${CHECK_INCLUDE_FILE_BATCH_VARS})
+      LIST(FIND CHECK_INCLUDE_FILE_BATCH_VARS ${CHECK_INCLUDE_FILE_BATCH_VAR}
+        CHECK_INCLUDE_FILE_BATCH_N)
+      LIST(GET CHECK_INCLUDE_FILE_BATCH_INCLUDES ${CHECK_INCLUDE_FILE_BATCH_N}
+        CHECK_INCLUDE_FILE_BATCH_INCLUDE)
+      IF(${CHECK_INCLUDE_FILE_BATCH_VAR})
+        MESSAGE(STATUS "Looking for ${CHECK_INCLUDE_FILE_BATCH_INCLUDE} - found")
+        SET(${CHECK_INCLUDE_FILE_BATCH_VAR} 1 CACHE INTERNAL
+          "Have include ${CHECK_INCLUDE_FILE_BATCH_INCLUDE}")
+      ELSE(${CHECK_INCLUDE_FILE_BATCH_VAR})
+        MESSAGE(STATUS "Looking for ${CHECK_INCLUDE_FILE_BATCH_INCLUDE} - not found")
+        SET(${CHECK_INCLUDE_FILE_BATCH_VAR} "" CACHE INTERNAL
+          "Have include ${CHECK_INCLUDE_FILE_BATCH_INCLUDE}")
+        SET(CHECK_INCLUDE_FILE_BATCH_FAILED 1)
+      ENDIF(${CHECK_INCLUDE_FILE_BATCH_VAR})
+    ENDFOREACH(CHECK_INCLUDE_FILE_BATCH_VAR)
+    IF(CHECK_INCLUDE_FILE_BATCH_FAILED)
+      FILE(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
+        "Determining if the include files ${CHECK_INCLUDE_FILE_BATCH_INCLUDES} "
+        "exist failed with the following output:\n"
+        "${OUTPUT}\n\n")
+    ELSE(CHECK_INCLUDE_FILE_BATCH_FAILED)
+      FILE(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
+        "Determining if the include files ${CHECK_INCLUDE_FILE_BATCH_INCLUDES} "
+        "exist passed with the following output:\n"
+        "${OUTPUT}\n\n")
+    ENDIF(CHECK_INCLUDE_FILE_BATCH_FAILED)
+  ENDIF(CHECK_INCLUDE_FILE_BATCH_VARS)
+ENDMACRO(CHECK_INCLUDE_FILE_BATCH)
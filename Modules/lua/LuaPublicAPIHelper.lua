@@ -78,122 +78,22 @@ end
 
 
 
--- private helper function that recursively parses a (nested) table of strings
--- and flattens them into array. (This was adapted from 'rconcat' from
--- Programming in Lua.)
--- The parameter 'big_table' is the current flattened array of items and on completion, this will contain the array of all items. Pass in an empty table when 
--- calling to start things.
--- The parameter 'list' is the list of parameters the user passes in. It can
--- be a string, or table of strings, or nested tables of strings.
--- The function returns partial lists for internal/private use for recursion.
-local function recursive_file_concat(big_table, list)
-	if type(list) ~= "table" then
---		print("not table:", list)
-		table.insert(big_table, list)
-		return list
-	end
-	local res = {}
-	for i=1, #list do
---		print("item", i, "is", list[i])
-		res[i] = recursive_file_concat(big_table, list[i])
-	end
---	print("returning res", res)
---	cmakelua.table_print(res)
-	return res
-end
-
-
-
--- Here we demonstrate some fancy argument handling for the convenience of the users
-
---[[
-function cm.add_library(library_name, ...)
-	local argument_table = {...} -- put the arguments in a table for easier handling
-	local number_of_args = #argument_table -- use the # operator to get the size of the table
-	-- print("Number of args is", number_of_args)
-
-	-- So now the fun stuff. There are a whole bunch of permutations we can support.
-	-- First, the user can use STATIC or SHARED or MODULE or omit the thing entirely.
-	-- So lets check if the first argument is any of these.
-
-
-	-- So for the file list, the user can do several things:
-	-- They can pass in a table containing all the files in an array:
-	-- list = { file1.c, file2.c, file3.c }
-	-- add_library(list)
-	--
-	-- They can pass in each file as an individual argument.
-	-- add_library("file1.c", "file2.c", "file3.c")
-	--
-	-- They can intersperse tables and individual files
-	-- list1 = { file1.c, file2.c, file3.c }
-	-- list2 = { file4.c, file5.c, file6.c }
-	-- add_library(list1, "filea.c", list2, "fileb.c")
-	--
-
-	local flattened_list = {}
-	recursive_file_concat(flattened_list, argument_table)
-
-
-	-- Call the 'real' C/Lua CMake function
-	return cmake.add_library(library_name, unpack(flattened_list))
-end
---]]
-
-local function setup_fancy_argument_handling(original_function)
-	local old_function = original_function
-
-	return function(...)
-		local argument_table = {...} -- put the arguments in a table for easier handling
-		local number_of_args = #argument_table -- use the # operator to get the size of the table
-
-		local flattened_list = {}
-		recursive_file_concat(flattened_list, argument_table)
-
-		--return old_function(unpack(flattened_list))
-		return old_function(flattened_list)
-	end
-end
-
-	
-
-
--- For every registered (C++) CMake API function (in cmake. table)
--- provide fancy argument handling
---for key, value in pairs(cmake) do
---[[
-for key, value in pairs(_G) do
-	if type(value) == "function" then
-		local func_name = string.match(key, '^cm_(.*)$')
-		if func_name then
---			print("Found function:", key, "func_name", func_name, ".")
-			--cmake[key] = setup_fancy_argument_handling(value)
-			--cmake[func_name] = value
-			cmake[func_name] = setup_fancy_argument_handling(value)
-			_G[key] = nil
-		end
-	else
---		print("Type:", type(value), "for key:", key)
-	end
-end
---]]
-
-for key, value in pairs(cmake) do
-	if type(value) == "function" then
---			print("Found function:", key, ".")
-			cmake[key] = setup_fancy_argument_handling(value)
-			
-			-- also make them global
-			--_G[key] = cmake[key] 
-			
-			--cmake[func_name] = value
-			--cmake[func_name] = setup_fancy_argument_handling(value)
-			--_G[key] = nil
-	else
---		print("Type:", type(value), "for key:", key)
-	end
-end
---print("end of helper")
+-- Argument handling for the convenience of the users:
+-- The C functions in the cmake table flatten their arguments themselves
+-- (see cmCommand::GetLuaArguments), so all of these work without any
+-- Lua-side wrapper or temporary tables:
+--
+-- They can pass in a table containing all the files in an array:
+-- list = { file1.c, file2.c, file3.c }
+-- cmake.add_library("foo", list)
+--
+-- They can pass in each file as an individual argument.
+-- cmake.add_library("foo", "file1.c", "file2.c", "file3.c")
+--
+-- They can intersperse (nested) tables and individual files
+-- list1 = { file1.c, file2.c, file3.c }
+-- list2 = { file4.c, file5.c, file6.c }
+-- cmake.add_library("foo", list1, "filea.c", list2, "fileb.c")
 
 
 
@@ -401,37 +301,31 @@ end
 
 
 	
+-- cmake.vars looks variables up in the current scope and the cache
+-- when they are read. CMake lists come back as arrays and arrays are
+-- stored as CMake lists, so no splitting or joining happens here.
+
+local cmake_vars = cmake.vars
+
+-- Global names: CMake variables first, then the cmake namespace.
+-- Values CMake can hold become CMake variables when written.
 setmetatable(_G, 
 {
 __index = function (_, n) 
-		local val = GetDefinition(n) 
+		local val = cmake_vars[n]
 		if val == nil then
-			val = cmake[n]
-			if val == nil then
-				return rawget(_G, n)
-			else
-				return val
-			end
+			return cmake[n]
 		else
-			-- return the CMake list as indexed table
-			local t = string.split(";", val) 
-			if #t == 1 then
-				return cmakelua.convert_to_native_lua_types(rawget(t, 1))
-			else
-				return cmakelua.convert_to_native_lua_types(t)
-			end
-		end		
+			return cmakelua.convert_to_native_lua_types(val)
+		end
 	end,
 __newindex = function (_, n1, n2)
-		if type(n2) == "boolean" then
-			AddDefinition(n1, tostring(n2))
-		elseif type(n2) == "number" then
-			AddDefinition(n1, tostring(n2))
-		elseif type(n2) == "string" then
-			AddDefinition(n1, n2)
+		local t = type(n2)
+		if t == "boolean" or t == "number" or t == "string" then
+			cmake_vars[n1] = n2
 		elseif cmakelua.is_string_list(n2) then 
 			-- only string lists are visible in CMake
-			AddDefinition(n1, string.join(";", n2)) 
+			cmake_vars[n1] = n2
 		else 
 			rawset(_G, n1, n2)
 		end
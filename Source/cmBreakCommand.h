@@ -35,6 +35,11 @@ public:
     return new cmBreakCommand;
     }
 
+  /**
+   * This determines if one instance may run many invocations.
+   */
+  virtual bool IsReusable() { return true; }
+
   /**
    * This is called when the command is first encountered in
    * the CMakeLists.txt file.
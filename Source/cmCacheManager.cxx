@@ -194,6 +194,7 @@ bool cmCacheManager::LoadCache(const char* path,
   if ( internal )
     {
     this->Cache.clear();
+    this->CacheIndex.clear();
     }
   if(!cmSystemTools::FileExists(cacheFile.c_str()))
     {
@@ -283,7 +284,7 @@ bool cmCacheManager::LoadCache(const char* path,
             if ( it.IsAtEnd() )
               {
               e.Type = cmCacheManager::UNINITIALIZED;
-              this->Cache[akey] = e;
+              this->GetOrCreateCacheEntry(akey.c_str()) = e;
               }
             if (!it.Find(akey.c_str()))
               {
@@ -304,7 +305,7 @@ bool cmCacheManager::LoadCache(const char* path,
             if ( it.IsAtEnd() )
               {
               e.Type = cmCacheManager::UNINITIALIZED;
-              this->Cache[akey] = e;
+              this->GetOrCreateCacheEntry(akey.c_str()) = e;
               }
             if (!it.Find(akey.c_str()))
               {
@@ -315,7 +316,7 @@ bool cmCacheManager::LoadCache(const char* path,
           else
             {
             e.Initialized = true;
-            this->Cache[entryKey] = e;
+            this->GetOrCreateCacheEntry(entryKey.c_str()) = e;
             }
           }
         }
@@ -712,6 +713,7 @@ void cmCacheManager::RemoveCacheEntry(const char* key)
   CacheEntryMap::iterator i = this->Cache.find(key);
   if(i != this->Cache.end())
     {
+    this->CacheIndex.erase(i->first);
     this->Cache.erase(i);
     }
   else
@@ -723,14 +725,28 @@ void cmCacheManager::RemoveCacheEntry(const char* key)
 
 cmCacheManager::CacheEntry *cmCacheManager::GetCacheEntry(const char* key)
 {
-  CacheEntryMap::iterator i = this->Cache.find(key);
-  if(i != this->Cache.end())
+  CacheIndexMap::iterator i = this->CacheIndex.find(key);
+  if(i != this->CacheIndex.end())
     {
-    return &i->second;
+    return i->second;
     }
   return 0;
 }
 
+cmCacheManager::CacheEntry&
+cmCacheManager::GetOrCreateCacheEntry(const char* key)
+{
+  CacheIndexMap::iterator i = this->CacheIndex.find(key);
+  if(i != this->CacheIndex.end())
+    {
+    return *i->second;
+    }
+  // Entries in a std::map never move, so the index may point at them.
+  CacheEntry* e = &this->Cache[key];
+  this->CacheIndex.insert(CacheIndexMap::value_type(key, e));
+  return *e;
+}
+
 cmCacheManager::CacheIterator cmCacheManager::GetCacheIterator(
   const char *key)
 {
@@ -739,11 +755,11 @@ cmCacheManager::CacheIterator cmCacheManager::GetCacheIterator(
 
 const char* cmCacheManager::GetCacheValue(const char* key) const
 {
-  CacheEntryMap::const_iterator i = this->Cache.find(key);
-  if(i != this->Cache.end() &&
-    i->second.Initialized)
+  CacheIndexMap::const_iterator i = this->CacheIndex.find(key);
+  if(i != this->CacheIndex.end() &&
+    i->second->Initialized)
     {
-    return i->second.Value.c_str();
+    return i->second->Value.c_str();
     }
   return 0;
 }
@@ -774,7 +790,7 @@ void cmCacheManager::AddCacheEntry(const char* key,
                                    const char* helpString,
                                    CacheEntryType type)
 {
-  CacheEntry& e = this->Cache[key];
+  CacheEntry& e = this->GetOrCreateCacheEntry(key);
   if ( value )
     {
     e.Value = value;
@@ -799,7 +815,6 @@ void cmCacheManager::AddCacheEntry(const char* key,
     e.Properties["HELPSTRING"] = 
       "(This variable does not exist and should not be used)";
     }
-  this->Cache[key] = e;
 }
 
 void cmCacheManager::AddCacheEntry(const char* key, bool v,
@@ -18,6 +18,11 @@
 #define cmCacheManager_h
 
 #include "cmStandardIncludes.h"
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+# include <cmsys/hash_map.hxx>
+#endif
+
 class cmMakefile;
 class cmMarkAsAdvancedCommand;
 
@@ -170,6 +175,29 @@ private:
   static void OutputHelpString(std::ofstream& fout, 
                                const std::string& helpString);
   CacheEntryMap Cache;
+
+  // The cache is kept sorted for writing and iteration, but every
+  // variable lookup that misses the current scope ends up here, so
+  // lookups by key go through a hash table of the map's entries.
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  class HashString
+    {
+  public:
+    size_t operator()(const cmStdString& s) const
+      {
+      return h(s.c_str());
+      }
+    cmsys::hash<const char*> h;
+    };
+  typedef cmsys::hash_map<cmStdString, CacheEntry*, HashString>
+    CacheIndexMap;
+#else
+  typedef std::map<cmStdString, CacheEntry*> CacheIndexMap;
+#endif
+  CacheIndexMap CacheIndex;
+
+  // Find or create the entry for a key, keeping the index up to date.
+  CacheEntry& GetOrCreateCacheEntry(const char* key);
   // Only cmake and cmMakefile should be able to add cache values
   // the commands should never use the cmCacheManager directly
   friend class cmMakefile; // allow access to add cache values
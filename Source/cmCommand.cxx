@@ -16,61 +16,193 @@
 =========================================================================*/
 
 #include "cmCommand.h"
+#include "cmake.h"
 #include "cmLuaUtils.h"
 
 static int cmLuaFunc(lua_State *L) 
 {
-  // build a list file function 
-  cmListFileFunction lff;
+  bool ok;
+  bool badArguments = false;
+  {
+  // the command name and the calling location
+  cmListFileContext lfc;
   cmExecutionStatus status;
-  lff.Name = lua_tostring(L, lua_upvalueindex(1));
-  
-  int i;
-  int top = lua_gettop(L);
-  /* The old way used variable number of arguments.
-   * The problem with this is that the max number of 
-   * arguments is capped at 2048. If people are
-   * list large number of files, we will get into trouble.
-   * So I'm switching the implementation to pass a single
-   * table (array) instead which doesn't have the cap.
-   */
-/*  
-  for (i = 1; i <= top; i++) 
-    { 
-    const char *arg = lua_tostring(L, i);
-    lff.Arguments.push_back(cmListFileArgument(arg, false,
-                                               0, 0));
+  lfc.Name = lua_tostring(L, lua_upvalueindex(1));
+  cmCommand::GetLuaContext(L, lfc);
+
+  std::vector<std::string> args;
+  std::string error;
+  if(!cmCommand::GetLuaArguments(L, args, error))
+    {
+    // Keep the message on the Lua stack, it must outlive this scope.
+    lua_pushstring(L, error.c_str());
+    badArguments = true;
+    }
+
+  // pass it to ExecuteCommand
+  cmMakefile *mf = cmCommand::GetLuaMakefile(L);
+  ok = !badArguments && mf->ExecuteCommand(lfc, args, status);
+
+  // return the primary output of the command, if any
+  const char* value = 0;
+  cmCommand* proto = ok?
+    mf->GetCMakeInstance()->GetCommand(lfc.Name.c_str()) : 0;
+  if(proto && proto->GetLuaResult(mf, args, value))
+    {
+    if(value && cmSystemTools::IsNOTFOUND(value))
+      {
+      value = 0;
+      }
+    cmCommand::PushLuaValue(L, value);
+    return 1;
+    }
+  }
+
+  // The error itself has been reported already.  Raise it in Lua only
+  // after the C++ objects above are gone, lua_error does not unwind.
+  if(badArguments)
+    {
+    luaL_error(L, "%s", lua_tostring(L, -1));
     }
-*/
- /* New way: uses a table (array) */
-  if(lua_istable(L, -1))
+  if(!ok)
     {
-    int array_length = luaL_getn(L, -1);	
-    for (i = 1; i<= array_length; i++)
+    luaL_error(L, "cmake.%s failed", lua_tostring(L, lua_upvalueindex(1)));
+    }
+  return 0;  /* number of results */
+}
+
+// Append the value at index idx, flattening nested arrays.  On failure
+// store a message in error and return false.  This must not raise a
+// Lua error itself, the callers have C++ objects to destroy first.
+static bool cmLuaFlattenArgument(lua_State *L, int idx,
+                                 std::vector<std::string>& args, int depth,
+                                 std::string& error)
+{
+  switch(lua_type(L, idx))
+    {
+    case LUA_TNIL:
+      break;
+    case LUA_TBOOLEAN:
+      args.push_back(lua_toboolean(L, idx)? "true" : "false");
+      break;
+    case LUA_TTABLE:
       {
-      lua_rawgeti(L, 1, i); // assumes table is first (and only) argument
-      const char *arg = lua_tostring(L, -1);
-      lff.Arguments.push_back(cmListFileArgument(arg, false,
-                                                 0, 0));
-      lua_pop(L, 1);
+      // Each level of nesting takes a slot on the Lua stack.
+      if(depth > 64 || !lua_checkstack(L, 1))
+        {
+        error = "arguments nested too deeply (recursive table?)";
+        return false;
+        }
+      int n = static_cast<int>(lua_objlen(L, idx));
+      args.reserve(args.size() + n);
+      for(int i = 1; i <= n; ++i)
+        {
+        lua_rawgeti(L, idx, i);
+        bool ok = cmLuaFlattenArgument(L, lua_gettop(L), args, depth + 1,
+                                       error);
+        lua_pop(L, 1);
+        if(!ok)
+          {
+          return false;
+          }
+        }
       }
-	}
+      break;
+    default:
+      {
+      size_t len = 0;
+      const char *arg = lua_tolstring(L, idx, &len);
+      if(!arg)
+        {
+        error = "cannot pass a ";
+        error += luaL_typename(L, idx);
+        error += " as a CMake argument";
+        return false;
+        }
+      else if(memchr(arg, ';', len))
+        {
+        cmSystemTools::ExpandListArgument(std::string(arg, len), args);
+        }
+      else
+        {
+        args.push_back(std::string(arg, len));
+        }
+      }
+      break;
+    }
+  return true;
+}
+
+bool cmCommand::GetLuaArguments(lua_State *L,
+                                std::vector<std::string>& args,
+                                std::string& error)
+{
+  int top = lua_gettop(L);
+  for(int i = 1; i <= top; ++i)
+    {
+    if(!cmLuaFlattenArgument(L, i, args, 0, error))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+void cmCommand::PushLuaValue(lua_State *L, const char* value)
+{
+  if(!value)
+    {
+    lua_pushnil(L);
+    }
+  else if(!strchr(value, ';'))
+    {
+    lua_pushstring(L, value);
+    }
   else
     {
-    std::cerr << "Error at: "
-      << LuaUtils_GetLocationString(L)
-      << "\nCMakeLua functions can only take a single table (array) parameter in cmCommand::cmLuaFunc(). It is expected that fancy argument handling is handled in LuaPublicAPIHelper.lua which should prepare all arguments to be formatted for this function. If this message is seen, either the helper failed or invocation bypassed the helper." << std::endl;
+    std::vector<std::string> items;
+    cmSystemTools::ExpandListArgument(value, items, true);
+    lua_createtable(L, static_cast<int>(items.size()), 0);
+    for(unsigned int i = 0; i < items.size(); ++i)
+      {
+      lua_pushlstring(L, items[i].data(), items[i].size());
+      lua_rawseti(L, -2, i + 1);
+      }
     }
-  // get the current makefile
-  lua_pushstring(L,"cmCurrentMakefile");
-  lua_gettable(L, LUA_REGISTRYINDEX);
-  cmMakefile *mf = static_cast<cmMakefile *>(lua_touserdata(L,-1));
+}
 
-  // pass it to ExecuteCommand
-  mf->ExecuteCommand(lff, status);
-  // What should I do with status?
+void cmCommand::GetLuaContext(lua_State *L, cmListFileContext& lfc)
+{
+  lfc.Line = 0;
+  lua_Debug ar;
+  if(lua_getstack(L, 1, &ar) && lua_getinfo(L, "Sl", &ar))
+    {
+    // file chunks are named "@<path>"
+    lfc.FilePath = ar.source[0] == '@'? ar.source+1 : ar.short_src;
+    lfc.Line = ar.currentline;
+    }
+}
 
-  return 0;  /* number of results */
+cmMakefile* cmCommand::GetLuaMakefile(lua_State *L)
+{
+  // The binding carries the cmake instance, which knows the makefile
+  // whose code runs now.  That need not be the directory the calling
+  // function was defined in.
+  cmMakefile *mf = 0;
+  if(cmake* cm =
+     static_cast<cmake *>(lua_touserdata(L, lua_upvalueindex(2))))
+    {
+    mf = cm->GetCurrentLuaMakefile();
+    }
+  if(!mf)
+    {
+    // get the current makefile
+    lua_pushstring(L,"cmCurrentMakefile");
+    lua_gettable(L, LUA_REGISTRYINDEX);
+    mf = static_cast<cmMakefile *>(lua_touserdata(L,-1));
+    lua_pop(L, 1);
+    }
+  return mf;
 }
 
 cmCommand::cmCommand()
@@ -68,6 +68,52 @@ public:
     return this->InitialPass(expandedArguments,status);
     }
 
+  /**
+   * This determines if the command may be invoked with arguments that
+   * are already split and expanded, as done by the Lua bindings.
+   * Commands that override InvokeInitialPass to see their raw
+   * arguments (flow control, macros, functions) must return false.
+   */
+  virtual bool AcceptsDirectArguments()
+    {
+    return true;
+    }
+
+  /**
+   * The variable that receives the primary output of a call with the
+   * given arguments, e.g. the VAR of find_library(VAR ...).  A cmake.*
+   * call from Lua returns its value.  Empty if there is none.
+   */
+  virtual std::string GetLuaResultVariable(std::vector<std::string> const&)
+    {
+    return std::string();
+    }
+
+  /**
+   * Most commands with a result take the name of its variable as their
+   * first argument, e.g. get_target_property(VAR target prop).  They
+   * implement GetLuaResultVariable with this.
+   */
+  static std::string
+  GetFirstArgument(std::vector<std::string> const& args)
+    {
+    return args.empty()? std::string() : args[0];
+    }
+
+  /**
+   * The value a cmake.* call from Lua returns once the command ran in
+   * mf, by default the value of its GetLuaResultVariable.  Returns
+   * false if the call has no result.
+   */
+  virtual bool GetLuaResult(cmMakefile* mf,
+                            std::vector<std::string> const& args,
+                            const char*& value)
+    {
+    std::string var = this->GetLuaResultVariable(args);
+    value = var.empty()? 0 : mf->GetDefinition(var.c_str());
+    return !var.empty();
+    }
+
   /**
    * This is called when the command is first encountered in
    * the CMakeLists.txt file.
@@ -82,11 +128,45 @@ public:
    * writing to the cache can be done.
    */
   virtual void FinalPass() {};
+
+  /**
+   * Does this command have a final pass?  Query after InitialPass.
+   * Only commands that do are kept until the final pass; the others
+   * are deleted right after they run.
+   */
+  virtual bool HasFinalPass() const { return false; }
+
+  /**
+   * Is this instance used after InitialPass, for example by a callback
+   * it registered?  Query after InitialPass.  Such instances are kept
+   * until the makefile is destroyed but get no final pass.
+   */
+  virtual bool IsUsedAfterInitialPass() const { return false; }
   
   /**
    * This is a virtual constructor for the command.
    */
   virtual cmCommand* Clone() = 0;
+
+  /**
+   * This determines if one instance may run many invocations, one
+   * after the other.  True for commands that keep nothing between
+   * calls to InitialPass.
+   */
+  virtual bool IsReusable()
+    {
+    return false;
+    }
+
+  /**
+   * Forget the makefile and error of the last invocation, so that a
+   * reusable instance looks like a fresh clone.
+   */
+  void Reset()
+    {
+    this->Makefile = 0;
+    this->Error = "";
+    }
   
   /**
    * This determines if the command is invoked when in script mode.
@@ -171,6 +251,39 @@ public:
   bool GetExposeToLua() { return this->ExposeToLua; };
   int (*LuaFunction)(lua_State *L);
 
+  /**
+   * The makefile a Lua binding runs for: the one whose Lua code runs
+   * when it is called.  The binding finds it through the cmake
+   * instance in its second upvalue, or in the registry while the
+   * instance has none set.
+   */
+  static cmMakefile* GetLuaMakefile(lua_State *L);
+
+  /**
+   * Fill in the file and line of the Lua code that called a binding,
+   * for the messages of the command it runs.
+   */
+  static void GetLuaContext(lua_State *L, cmListFileContext& lfc);
+
+  /**
+   * Collect the arguments of a Lua call.  Strings, numbers and
+   * (nested) arrays of them may be mixed freely, e.g.
+   * cmake.add_library("foo", cmake.STATIC, sources, "extra.c").
+   * Elements are copied once and no Lua tables are built on the way.
+   * Returns false with a message in error for an argument that cannot
+   * be passed.  No Lua error is raised, the caller raises it once its
+   * C++ objects are destroyed.
+   */
+  static bool GetLuaArguments(lua_State *L,
+                              std::vector<std::string>& args,
+                              std::string& error);
+
+  /**
+   * Push the value of a CMake variable: nil when it is undefined, an
+   * array for a list and a string otherwise.
+   */
+  static void PushLuaValue(lua_State *L, const char* value);
+
 protected:
   cmMakefile* Makefile;
   cmCommandArgumentsHelper Helper;
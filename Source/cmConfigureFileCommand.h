@@ -79,6 +79,7 @@ public:
     }
 
   virtual void FinalPass();
+  virtual bool HasFinalPass() const { return true; }
 private:
   int ConfigureFile();
   
@@ -18,9 +18,16 @@
 #include "cmake.h"
 #include "cmCacheManager.h"
 #include "cmGlobalGenerator.h"
+#include "cmGeneratedFileStream.h"
+#include "cmLocalGenerator.h"
+#include "cmProfiler.h"
+#include "cmVersion.h"
 #include <cmsys/Directory.hxx>
 
-int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv)
+#include <algorithm>
+
+int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
+                                     bool cacheResult)
 {
   
   this->BinaryDirectory = argv[1].c_str();
@@ -149,6 +156,8 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv)
     }
   
   std::string outFileName = this->BinaryDirectory + "/CMakeLists.txt";
+  std::string resultCacheFile;
+  const char* lang = 0;
   // which signature are we using? If we are using var srcfile bindir
   if (this->SrcFileSignature)
     {
@@ -160,6 +169,13 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv)
     // first create the directories
     sourceDirectory = this->BinaryDirectory.c_str();
 
+    std::string source = argv[2];
+    lang = this->GetSourceLanguage(source);
+    if(!lang)
+      {
+      return -1;
+      }
+
     // now create a CMakeList.txt file in that directory
     FILE *fout = fopen(outFileName.c_str(),"w");
     if (!fout)
@@ -169,88 +185,10 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv)
       cmSystemTools::ReportLastSystemError("");
       return -1;
       }
-
-    std::string source = argv[2];
-    std::string ext = cmSystemTools::GetFilenameExtension(source);
-    const char* lang =(this->Makefile->GetCMakeInstance()->GetGlobalGenerator()
-                        ->GetLanguageFromExtension(ext.c_str()));
-    const char* def = this->Makefile->GetDefinition("CMAKE_MODULE_PATH");
-    fprintf(fout, "cmake_minimum_required(VERSION %u.%u)\n",
-            cmVersion::GetMajorVersion(), cmVersion::GetMinorVersion());
-    if(def)
-      {
-      fprintf(fout, "SET(CMAKE_MODULE_PATH %s)\n", def);
-      }
-    if(lang)
-      {
-      fprintf(fout, "PROJECT(CMAKE_TRY_COMPILE %s)\n", lang);
-      }
-    else
-      {
-      cmOStringStream err;
-      err << "Unknown extension \"" << ext << "\" for file \""
-          << source << "\".  TRY_COMPILE only works for enabled languages.\n"
-          << "Currently enabled languages are:";
-      std::vector<std::string> langs;
-      this->Makefile->GetCMakeInstance()->GetGlobalGenerator()->
-        GetEnabledLanguages(langs);
-      for(std::vector<std::string>::iterator l = langs.begin();
-          l != langs.end(); ++l)
-        {
-        err << " " << *l;
-        }
-      err << "\nSee PROJECT command for help enabling other languages.";
-      cmSystemTools::Error(err.str().c_str());
-      fclose(fout);
-      return -1;
-      }
-    std::string langFlags = "CMAKE_";
-    langFlags +=  lang;
-    langFlags += "_FLAGS";
-    fprintf(fout, "SET(CMAKE_VERBOSE_MAKEFILE 1)\n");
-    fprintf(fout, "SET(CMAKE_%s_FLAGS \"", lang);
-    const char* flags = this->Makefile->GetDefinition(langFlags.c_str()); 
-    if(flags)
-      {
-      fprintf(fout, " %s ", flags);
-      }
-    fprintf(fout, " ${COMPILE_DEFINITIONS}\")\n");
-    fprintf(fout, "INCLUDE_DIRECTORIES(${INCLUDE_DIRECTORIES})\n");
-    fprintf(fout, "SET(CMAKE_SUPPRESS_REGENERATION 1)\n");
-    fprintf(fout, "LINK_DIRECTORIES(${LINK_DIRECTORIES})\n");
-    // handle any compile flags we need to pass on
-    if (compileFlags.size())
-      {
-      fprintf(fout, "ADD_DEFINITIONS( ");
-      for (i = 0; i < compileFlags.size(); ++i)
-        {
-        fprintf(fout,"%s ",compileFlags[i].c_str());
-        }
-      fprintf(fout, ")\n");
-      }
-
-    /* for the TRY_COMPILEs we want to be able to specify the architecture.
-      So the user can set CMAKE_OSX_ARCHITECTURE to i386;ppc and then set 
-      CMAKE_TRY_COMPILE_OSX_ARCHITECTURE first to i386 and then to ppc to
-      have the tests run for each specific architecture. Since 
-      cmLocalGenerator doesn't allow building for "the other" 
-      architecture only via CMAKE_OSX_ARCHITECTURES,use to CMAKE_DO_TRY_COMPILE
-      to enforce it for this case here.
-      */
-    cmakeFlags.push_back("-DCMAKE_DO_TRY_COMPILE=TRUE");
-    if(this->Makefile->GetDefinition("CMAKE_TRY_COMPILE_OSX_ARCHITECTURES")!=0)
-      {
-      std::string flag="-DCMAKE_OSX_ARCHITECTURES=";
-      flag += this->Makefile->GetSafeDefinition(
-                                        "CMAKE_TRY_COMPILE_OSX_ARCHITECTURES");
-      cmakeFlags.push_back(flag);
-      }
-    else if (this->Makefile->GetDefinition("CMAKE_OSX_ARCHITECTURES")!=0)
-      {
-      std::string flag="-DCMAKE_OSX_ARCHITECTURES=";
-      flag += this->Makefile->GetSafeDefinition("CMAKE_OSX_ARCHITECTURES");
-      cmakeFlags.push_back(flag);
-      }
+    std::vector<std::string> langs;
+    langs.push_back(lang);
+    this->WriteProjectHeader(fout, langs, compileFlags);
+    this->AddSourceFileCMakeFlags(cmakeFlags);
 
     fprintf(fout, "ADD_EXECUTABLE(cmTryCompileExec \"%s\")\n",source.c_str());
     fprintf(fout, 
@@ -258,6 +196,12 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv)
     fclose(fout);
     projectName = "CMAKE_TRY_COMPILE";
     targetName = "cmTryCompileExec";
+    // COPY_FILE needs the program itself.
+    if(cacheResult && copyFile.empty())
+      {
+      resultCacheFile = this->GetResultCacheFile(lang, source, compileFlags,
+                                                 cmakeFlags);
+      }
     // if the source is not in CMakeTmp 
     if(source.find("CMakeTmp") == source.npos)
       {
@@ -276,19 +220,35 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv)
       }
     }
   
-  bool erroroc = cmSystemTools::GetErrorOccuredFlag();
-  cmSystemTools::ResetErrorOccuredFlag();
   std::string output;
-  // actually do the try compile now that everything is setup
-  int res = this->Makefile->TryCompile(sourceDirectory, 
+  int res;
+  bool cached = !resultCacheFile.empty() &&
+    this->LoadCachedResult(resultCacheFile, res, output);
+  if(!cached)
+    {
+    bool erroroc = cmSystemTools::GetErrorOccuredFlag();
+    cmSystemTools::ResetErrorOccuredFlag();
+    // actually do the try compile now that everything is setup
+    if(!this->SrcFileSignature ||
+       !this->TryCompileDirect(lang, argv[2], compileFlags, cmakeFlags,
+                               res, output))
+      {
+      res = this->Makefile->TryCompile(sourceDirectory, 
                                        this->BinaryDirectory.c_str(),
                                        projectName, 
                                        targetName, 
                                        &cmakeFlags, 
                                        &output);
-  if ( erroroc )
-    {
-    cmSystemTools::SetErrorOccured();
+      }
+    // A build that failed because of an internal error may pass later.
+    if(!resultCacheFile.empty() && !cmSystemTools::GetErrorOccuredFlag())
+      {
+      this->StoreCachedResult(resultCacheFile, res, output);
+      }
+    if ( erroroc )
+      {
+      cmSystemTools::SetErrorOccured();
+      }
     }
   
   // set the result var to the return value to indicate success or failure
@@ -302,7 +262,7 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv)
     this->Makefile->AddDefinition(outputVariable.c_str(), output.c_str());
     }
   
-  if (this->SrcFileSignature)
+  if (this->SrcFileSignature && !cached)
     {
     this->FindOutputFile(targetName);
     if ((res==0) && (copyFile.size()))
@@ -318,6 +278,694 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv)
   return res;
 }
 
+//----------------------------------------------------------------------------
+static bool cmCoreTryCompileIsPlainText(std::string const& s,
+                                        bool separators)
+{
+  // Text that needs no quoting for the shell or RunSingleCommand.  A
+  // list of flags may be separated by spaces, which both split at, but
+  // a single path or definition must not contain any.
+  const char* allowed = separators? " _-=+./:,@%" : "_-=+./:,@%";
+  for(std::string::const_iterator c = s.begin(); c != s.end(); ++c)
+    {
+    if(!isalnum(static_cast<unsigned char>(*c)) &&
+       (*c == 0 || !strchr(allowed, *c)))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool cmCoreTryCompile::TryCompileDirect(const char* lang,
+                                        std::string const& source,
+                                        std::vector<std::string> const& defs,
+                                        std::vector<std::string> const& flags,
+                                        int& res, std::string& output)
+{
+  // The commands of the generated project are known only for the
+  // makefile generators, which run them in a POSIX shell.
+  cmake* cm = this->Makefile->GetCMakeInstance();
+  const char* direct =
+    this->Makefile->GetDefinition("CMAKE_TRY_COMPILE_DIRECT");
+  if((direct && *direct && cmSystemTools::IsOff(direct)) ||
+     cm->GetDebugTryCompile() ||
+     strcmp(cm->GetGlobalGenerator()->GetName(), "Unix Makefiles") != 0 ||
+     (strcmp(lang, "C") != 0 && strcmp(lang, "CXX") != 0))
+    {
+    return false;
+    }
+
+  // Settings with which the project would choose other flags than the
+  // ones computed here.
+  static const char* projectVars[] =
+    {
+    "CMAKE_TRY_COMPILE_CONFIGURATION",
+    "CMAKE_TRY_COMPILE_OSX_ARCHITECTURES",
+    "CMAKE_OSX_ARCHITECTURES",
+    "CMAKE_BUILD_TYPE_INIT",
+    "CMAKE_EXE_LINKER_FLAGS",
+    "CMAKE_EXE_LINKER_FLAGS_INIT",
+    0
+    };
+  for(const char** v = projectVars; *v; ++v)
+    {
+    std::string value = this->Makefile->GetSafeDefinition(*v);
+    if(value.find_first_not_of(" \t") != value.npos)
+      {
+      return false;
+      }
+    }
+  const char* ldflags = cmSystemTools::GetEnv("LDFLAGS");
+  if(ldflags && std::string(ldflags).find_first_not_of(" \t") != 
+     std::string::npos)
+    {
+    return false;
+    }
+
+  // The cache entries the project would be configured with.
+  std::string definitions;
+  std::vector<std::string> includes;
+  std::vector<std::string>::const_iterator i;
+  for(i = flags.begin(); i != flags.end(); ++i)
+    {
+    if(i->empty() || *i == "CMAKE_FLAGS" ||
+       *i == "-DCMAKE_DO_TRY_COMPILE=TRUE")
+      {
+      continue;
+      }
+    std::string::size_type eq = i->find('=');
+    if(i->substr(0, 2) != "-D" || eq == i->npos)
+      {
+      return false;
+      }
+    std::string name = i->substr(2, eq-2);
+    name = name.substr(0, name.find(':'));
+    std::string value = i->substr(eq+1);
+    if(name == "COMPILE_DEFINITIONS")
+      {
+      definitions = value;
+      }
+    else if(name == "INCLUDE_DIRECTORIES")
+      {
+      cmSystemTools::ExpandListArgument(value, includes);
+      }
+    else if(name == "CMAKE_SKIP_RPATH")
+      {
+      // There are no libraries needing a runtime path.
+      }
+    else if(!value.empty() ||
+            (name != "LINK_DIRECTORIES" && name != "LINK_LIBRARIES"))
+      {
+      return false;
+      }
+    }
+
+  // The flags the project would compute; see WriteProjectHeader.
+  std::string langFlags = " ";
+  std::string langFlagsVar = "CMAKE_";
+  langFlagsVar += lang;
+  langFlagsVar += "_FLAGS";
+  langFlags += this->Makefile->GetSafeDefinition(langFlagsVar.c_str());
+  langFlags += " ";
+  langFlags += definitions;
+  if(!cmCoreTryCompileIsPlainText(langFlags, true))
+    {
+    return false;
+    }
+  std::string includeFlagVar = "CMAKE_INCLUDE_FLAG_";
+  includeFlagVar += lang;
+  std::string includeSepVar = "CMAKE_INCLUDE_FLAG_SEP_";
+  includeSepVar += lang;
+  if(this->Makefile->GetDefinition(includeSepVar.c_str()) ||
+     this->Makefile->GetDefinition("CMAKE_QUOTE_INCLUDE_PATHS"))
+    {
+    return false;
+    }
+  std::set<cmStdString> emitted;
+  emitted.insert("/usr/include");
+  std::vector<std::string> implicit;
+  cmSystemTools::ExpandListArgument(
+    this->Makefile->GetSafeDefinition(
+      "CMAKE_PLATFORM_IMPLICIT_INCLUDE_DIRECTORIES"), implicit);
+  emitted.insert(implicit.begin(), implicit.end());
+  std::string compileFlags;
+  for(i = includes.begin(); i != includes.end(); ++i)
+    {
+    std::string dir =
+      cmSystemTools::CollapseFullPath(i->c_str(),
+                                      this->BinaryDirectory.c_str());
+    if(!cmCoreTryCompileIsPlainText(dir, false))
+      {
+      return false;
+      }
+    if(emitted.insert(dir).second)
+      {
+      compileFlags += " ";
+      compileFlags +=
+        this->Makefile->GetSafeDefinition(includeFlagVar.c_str());
+      compileFlags += dir;
+      }
+    }
+  std::string defines;
+  for(i = defs.begin(); i != defs.end(); ++i)
+    {
+    if(!cmCoreTryCompileIsPlainText(*i, false))
+      {
+      return false;
+      }
+    std::string& d = (i->substr(0, 2) == "-D")? defines : compileFlags;
+    d += " ";
+    d += *i;
+    }
+
+  std::string objectDir = this->BinaryDirectory;
+  objectDir += cmake::GetCMakeFilesDirectory();
+  objectDir += "/cmTryCompileExec.dir";
+  std::string object = objectDir;
+  object += "/";
+  object += cmSystemTools::GetFilenameName(source);
+  object += this->Makefile->GetSafeDefinition(
+    (std::string("CMAKE_") + lang + "_OUTPUT_EXTENSION").c_str());
+  std::string target = this->BinaryDirectory;
+  target += "/cmTryCompileExec";
+  target += this->Makefile->GetSafeDefinition("CMAKE_EXECUTABLE_SUFFIX");
+  std::vector<std::string> commands;
+  if(!this->Makefile->GetLocalGenerator()->GetExecutableBuildCommands(
+       lang, source.c_str(), object.c_str(), target.c_str(),
+       langFlags.c_str(), compileFlags.c_str(), defines.c_str(), commands))
+    {
+    return false;
+    }
+  for(i = commands.begin(); i != commands.end(); ++i)
+    {
+    if(i->find_first_of("$&|;<>`") != i->npos)
+      {
+      return false;
+      }
+    }
+
+  cmProfiler* profiler = cm->GetProfiler();
+  if(profiler)
+    {
+    profiler->Start("try_compile", "try_compile direct build",
+                    this->BinaryDirectory.c_str(), 0);
+    }
+  cmSystemTools::MakeDirectory(objectDir.c_str());
+  cmSystemTools::RemoveFile(object.c_str());
+  cmSystemTools::RemoveFile(target.c_str());
+  output += "Change Dir: ";
+  output += this->BinaryDirectory;
+  output += "\n";
+  res = 0;
+  for(i = commands.begin(); i != commands.end() && res == 0; ++i)
+    {
+    output += "\nRun Build Command:";
+    output += *i;
+    output += "\n";
+    std::string commandOutput;
+    if(!cmSystemTools::RunSingleCommand(i->c_str(), &commandOutput, &res,
+                                        this->BinaryDirectory.c_str(),
+                                        false))
+      {
+      output += "Could not run the command.\n";
+      res = 1;
+      }
+    output += commandOutput;
+    }
+  // Like cmGlobalGenerator::Build, for compilers that do not fail on
+  // #error.
+  if(res == 0 && output.find("#error") != output.npos)
+    {
+    res = 1;
+    }
+  if(profiler)
+    {
+    profiler->Stop();
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int cmCoreTryCompile::TryCompileBatch(std::vector<std::string> const& argv)
+{
+  // try_compile(BATCH bindir SOURCES <var> <srcfile>...
+  //             [CMAKE_FLAGS ...] [COMPILE_DEFINITIONS ...]
+  //             [OUTPUT_VARIABLE var])
+  enum Doing { DoingNone, DoingSources, DoingCMakeFlags, DoingDefinitions,
+               DoingOutput };
+  Doing doing = DoingNone;
+  this->SrcFileSignature = false;
+  std::vector<std::string> resultVars;
+  std::vector<std::string> sources;
+  std::vector<std::string> cmakeFlags;
+  std::vector<std::string> compileFlags;
+  std::string outputVariable;
+  // CMAKE_FLAGS stays the first argument to serve as argv[0], see
+  // TryCompileCode.
+  cmakeFlags.push_back("CMAKE_FLAGS");
+  unsigned int i;
+  for(i = 2; i < argv.size(); ++i)
+    {
+    if(argv[i] == "SOURCES")
+      {
+      doing = DoingSources;
+      }
+    else if(argv[i] == "CMAKE_FLAGS")
+      {
+      doing = DoingCMakeFlags;
+      }
+    else if(argv[i] == "COMPILE_DEFINITIONS")
+      {
+      doing = DoingDefinitions;
+      }
+    else if(argv[i] == "OUTPUT_VARIABLE")
+      {
+      doing = DoingOutput;
+      }
+    else if(doing == DoingSources)
+      {
+      if(resultVars.size() == sources.size())
+        {
+        resultVars.push_back(argv[i]);
+        }
+      else
+        {
+        sources.push_back(argv[i]);
+        }
+      }
+    else if(doing == DoingCMakeFlags)
+      {
+      cmakeFlags.push_back(argv[i]);
+      }
+    else if(doing == DoingDefinitions)
+      {
+      compileFlags.push_back(argv[i]);
+      }
+    else if(doing == DoingOutput)
+      {
+      outputVariable = argv[i];
+      doing = DoingNone;
+      }
+    else
+      {
+      cmSystemTools::Error("BATCH given unknown argument ",
+                           argv[i].c_str());
+      return -1;
+      }
+    }
+  if(sources.empty() || sources.size() != resultVars.size())
+    {
+    cmSystemTools::Error("BATCH requires SOURCES followed by pairs of a "
+                         "result variable and a source file.");
+    return -1;
+    }
+
+  this->SrcFileSignature = true;
+  this->OutputFile = "";
+  this->BinaryDirectory = argv[1];
+  this->BinaryDirectory += cmake::GetCMakeFilesDirectory();
+  this->BinaryDirectory += "/CMakeTmp";
+  cmSystemTools::MakeDirectory(this->BinaryDirectory.c_str());
+  if (this->BinaryDirectory == this->Makefile->GetHomeOutputDirectory())
+    {
+    cmSystemTools::Error(
+      "Attempt at a recursive or nested TRY_COMPILE in directory ",
+      this->BinaryDirectory.c_str());
+    return -1;
+    }
+  std::string ccFile = this->BinaryDirectory + "/CMakeCache.txt";
+  cmSystemTools::RemoveFile(ccFile.c_str());
+
+  std::vector<std::string> langs;
+  for(i = 0; i < sources.size(); ++i)
+    {
+    const char* lang = this->GetSourceLanguage(sources[i]);
+    if(!lang)
+      {
+      return -1;
+      }
+    if(std::find(langs.begin(), langs.end(), lang) == langs.end())
+      {
+      langs.push_back(lang);
+      }
+    }
+
+  // One executable for every source.  They do not depend on each
+  // other, so the build tool may build them in parallel.
+  std::string outFileName = this->BinaryDirectory + "/CMakeLists.txt";
+  FILE *fout = fopen(outFileName.c_str(),"w");
+  if (!fout)
+    {
+    cmSystemTools::Error("Failed to create CMakeList file for ", 
+                         outFileName.c_str());
+    cmSystemTools::ReportLastSystemError("");
+    return -1;
+    }
+  this->WriteProjectHeader(fout, langs, compileFlags);
+  std::vector<std::string> targets;
+  for(i = 0; i < sources.size(); ++i)
+    {
+    char target[64];
+    sprintf(target, "cmTryCompileExec%u", i);
+    targets.push_back(target);
+    fprintf(fout, "ADD_EXECUTABLE(%s \"%s\")\n", target, sources[i].c_str());
+    fprintf(fout, "TARGET_LINK_LIBRARIES(%s ${LINK_LIBRARIES})\n", target);
+    if(sources[i].find("CMakeTmp") == sources[i].npos)
+      {
+      this->Makefile->AddCMakeDependFile(sources[i].c_str());
+      }
+
+    // The result is whether the executable exists, so remove those
+    // kept from an earlier batch by --debug-trycompile.
+    this->FindOutputFile(target);
+    while(!this->OutputFile.empty() &&
+          cmSystemTools::RemoveFile(this->OutputFile.c_str()))
+      {
+      this->FindOutputFile(target);
+      }
+    }
+  fclose(fout);
+  this->AddSourceFileCMakeFlags(cmakeFlags);
+
+  unsigned int jobs = cmSystemTools::GetNumberOfProcessors();
+  const char* jobsDef =
+    this->Makefile->GetDefinition("CMAKE_TRY_COMPILE_BATCH_JOBS");
+  if(jobsDef && atoi(jobsDef) > 0)
+    {
+    jobs = static_cast<unsigned int>(atoi(jobsDef));
+    }
+  cmGlobalGenerator* gg =
+    this->Makefile->GetCMakeInstance()->GetGlobalGenerator();
+  std::string options = gg->GenerateParallelBuildOptions(jobs);
+
+  std::string output;
+  int res;
+  bool erroroc = cmSystemTools::GetErrorOccuredFlag();
+  cmSystemTools::ResetErrorOccuredFlag();
+  if(!options.empty())
+    {
+    // Build everything at once, past the sources that fail.
+    res = this->Makefile->TryCompile(this->BinaryDirectory.c_str(),
+                                     this->BinaryDirectory.c_str(),
+                                     "CMAKE_TRY_COMPILE", 0,
+                                     &cmakeFlags, &output, options.c_str());
+    }
+  else
+    {
+    // The build tool stops at the first failure, so build the targets
+    // one at a time.  The project is still configured only once.
+    res = this->Makefile->TryCompile(this->BinaryDirectory.c_str(),
+                                     this->BinaryDirectory.c_str(),
+                                     "CMAKE_TRY_COMPILE",
+                                     targets[0].c_str(),
+                                     &cmakeFlags, &output);
+    for(i = 1; i < targets.size() && !cmSystemTools::GetErrorOccuredFlag();
+        ++i)
+      {
+      if(gg->TryCompile(this->BinaryDirectory.c_str(),
+                        this->BinaryDirectory.c_str(),
+                        "CMAKE_TRY_COMPILE", targets[i].c_str(),
+                        &output, this->Makefile) != 0)
+        {
+        res = 1;
+        }
+      }
+    }
+  if ( erroroc )
+    {
+    cmSystemTools::SetErrorOccured();
+    }
+
+  for(i = 0; i < targets.size(); ++i)
+    {
+    this->FindOutputFile(targets[i].c_str());
+    this->Makefile->AddCacheDefinition(resultVars[i].c_str(),
+                                       (this->OutputFile.empty()?
+                                        "FALSE" : "TRUE"),
+                                       "Result of TRY_COMPILE",
+                                       cmCacheManager::INTERNAL);
+    }
+  if ( outputVariable.size() > 0 )
+    {
+    this->Makefile->AddDefinition(outputVariable.c_str(), output.c_str());
+    }
+  this->OutputFile = "";
+  return res;
+}
+
+//----------------------------------------------------------------------------
+const char* cmCoreTryCompile::GetSourceLanguage(std::string const& source)
+{
+  cmGlobalGenerator* gg =
+    this->Makefile->GetCMakeInstance()->GetGlobalGenerator();
+  std::string ext = cmSystemTools::GetFilenameExtension(source);
+  if(const char* lang = gg->GetLanguageFromExtension(ext.c_str()))
+    {
+    return lang;
+    }
+  cmOStringStream err;
+  err << "Unknown extension \"" << ext << "\" for file \""
+      << source << "\".  TRY_COMPILE only works for enabled languages.\n"
+      << "Currently enabled languages are:";
+  std::vector<std::string> langs;
+  gg->GetEnabledLanguages(langs);
+  for(std::vector<std::string>::iterator l = langs.begin();
+      l != langs.end(); ++l)
+    {
+    err << " " << *l;
+    }
+  err << "\nSee PROJECT command for help enabling other languages.";
+  cmSystemTools::Error(err.str().c_str());
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+void
+cmCoreTryCompile::WriteProjectHeader(FILE* fout,
+                                     std::vector<std::string> const& langs,
+                                     std::vector<std::string> const& defs)
+{
+  const char* def = this->Makefile->GetDefinition("CMAKE_MODULE_PATH");
+  fprintf(fout, "cmake_minimum_required(VERSION %u.%u)\n",
+          cmVersion::GetMajorVersion(), cmVersion::GetMinorVersion());
+  if(def)
+    {
+    fprintf(fout, "SET(CMAKE_MODULE_PATH %s)\n", def);
+    }
+  fprintf(fout, "PROJECT(CMAKE_TRY_COMPILE");
+  std::vector<std::string>::const_iterator li;
+  for(li = langs.begin(); li != langs.end(); ++li)
+    {
+    fprintf(fout, " %s", li->c_str());
+    }
+  fprintf(fout, ")\n");
+  fprintf(fout, "SET(CMAKE_VERBOSE_MAKEFILE 1)\n");
+  for(li = langs.begin(); li != langs.end(); ++li)
+    {
+    std::string langFlags = "CMAKE_";
+    langFlags += *li;
+    langFlags += "_FLAGS";
+    fprintf(fout, "SET(CMAKE_%s_FLAGS \"", li->c_str());
+    const char* flags = this->Makefile->GetDefinition(langFlags.c_str()); 
+    if(flags)
+      {
+      fprintf(fout, " %s ", flags);
+      }
+    fprintf(fout, " ${COMPILE_DEFINITIONS}\")\n");
+    }
+  fprintf(fout, "INCLUDE_DIRECTORIES(${INCLUDE_DIRECTORIES})\n");
+  fprintf(fout, "SET(CMAKE_SUPPRESS_REGENERATION 1)\n");
+  fprintf(fout, "LINK_DIRECTORIES(${LINK_DIRECTORIES})\n");
+  // handle any compile flags we need to pass on
+  if (defs.size())
+    {
+    fprintf(fout, "ADD_DEFINITIONS( ");
+    for (unsigned int i = 0; i < defs.size(); ++i)
+      {
+      fprintf(fout,"%s ",defs[i].c_str());
+      }
+    fprintf(fout, ")\n");
+    }
+}
+
+//----------------------------------------------------------------------------
+void
+cmCoreTryCompile::AddSourceFileCMakeFlags(std::vector<std::string>& flags)
+{
+  /* for the TRY_COMPILEs we want to be able to specify the architecture.
+    So the user can set CMAKE_OSX_ARCHITECTURE to i386;ppc and then set 
+    CMAKE_TRY_COMPILE_OSX_ARCHITECTURE first to i386 and then to ppc to
+    have the tests run for each specific architecture. Since 
+    cmLocalGenerator doesn't allow building for "the other" 
+    architecture only via CMAKE_OSX_ARCHITECTURES,use to CMAKE_DO_TRY_COMPILE
+    to enforce it for this case here.
+    */
+  flags.push_back("-DCMAKE_DO_TRY_COMPILE=TRUE");
+  if(this->Makefile->GetDefinition("CMAKE_TRY_COMPILE_OSX_ARCHITECTURES")!=0)
+    {
+    std::string flag="-DCMAKE_OSX_ARCHITECTURES=";
+    flag += this->Makefile->GetSafeDefinition(
+                                      "CMAKE_TRY_COMPILE_OSX_ARCHITECTURES");
+    flags.push_back(flag);
+    }
+  else if (this->Makefile->GetDefinition("CMAKE_OSX_ARCHITECTURES")!=0)
+    {
+    std::string flag="-DCMAKE_OSX_ARCHITECTURES=";
+    flag += this->Makefile->GetSafeDefinition("CMAKE_OSX_ARCHITECTURES");
+    flags.push_back(flag);
+    }
+}
+
+//----------------------------------------------------------------------------
+std::string
+cmCoreTryCompile::GetResultCacheFile(const char* lang,
+                                     std::string const& source,
+                                     std::vector<std::string> const& defs,
+                                     std::vector<std::string> const& flags)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  const char* dir =
+    this->Makefile->GetDefinition("CMAKE_TRY_COMPILE_CACHE_DIR");
+  if(!dir || !*dir)
+    {
+    dir = cmSystemTools::GetEnv("CMAKE_TRY_COMPILE_CACHE_DIR");
+    }
+  if(!dir || !*dir)
+    {
+    return "";
+    }
+
+  // The source text.  Its directory matters only for sources outside
+  // of CMakeTmp, which may include files next to them.
+  char md5[33];
+  if(!cmSystemTools::ComputeFileMD5(source.c_str(), md5))
+    {
+    return "";
+    }
+  md5[32] = 0;
+  cmOStringStream key;
+  key << "source " << md5 << " ";
+  if(source.find("CMakeTmp") == source.npos)
+    {
+    key << source << "\n";
+    }
+  else
+    {
+    key << cmSystemTools::GetFilenameName(source) << "\n";
+    }
+
+  // The toolchain: the compiler program and the compiler information
+  // file the try_compile project loads.
+  std::string langVar = "CMAKE_";
+  langVar += lang;
+  const char* compiler =
+    this->Makefile->GetDefinition((langVar + "_COMPILER").c_str());
+  key << "cmake " << cmVersion::GetCMakeVersion() << "\n"
+      << "generator "
+      << this->Makefile->GetCMakeInstance()->GetGlobalGenerator()->GetName()
+      << "\n"
+      << "make " << this->Makefile->GetSafeDefinition("CMAKE_MAKE_PROGRAM")
+      << "\n"
+      << "language " << lang << "\n";
+  if(compiler)
+    {
+    key << "compiler " << compiler << " "
+        << cmSystemTools::FileLength(compiler) << " "
+        << cmSystemTools::ModifiedTime(compiler) << "\n";
+    }
+  std::string info = this->Makefile->GetHomeOutputDirectory();
+  info += cmake::GetCMakeFilesDirectory();
+  info += "/CMake";
+  info += lang;
+  info += "Compiler.cmake";
+  if(cmSystemTools::ComputeFileMD5(info.c_str(), md5))
+    {
+    key << "info " << md5 << "\n";
+    }
+
+  // The settings written into the project and given to its cache.
+  key << "flags " << this->Makefile->GetSafeDefinition((langVar +
+                                                        "_FLAGS").c_str())
+      << "\n"
+      << "modules " << this->Makefile->GetSafeDefinition("CMAKE_MODULE_PATH")
+      << "\n";
+
+  // The settings the project links and chooses its configuration with.
+  static const char* linkVars[] =
+    {
+    "CMAKE_TRY_COMPILE_CONFIGURATION",
+    "CMAKE_EXE_LINKER_FLAGS",
+    "CMAKE_EXE_LINKER_FLAGS_INIT",
+    0
+    };
+  for(const char** v = linkVars; *v; ++v)
+    {
+    key << *v << " " << this->Makefile->GetSafeDefinition(*v) << "\n";
+    }
+  const char* ldflags = cmSystemTools::GetEnv("LDFLAGS");
+  key << "LDFLAGS " << (ldflags? ldflags : "") << "\n";
+  std::vector<std::string>::const_iterator i;
+  for(i = defs.begin(); i != defs.end(); ++i)
+    {
+    key << "definition " << *i << "\n";
+    }
+  for(i = flags.begin(); i != flags.end(); ++i)
+    {
+    key << "cmake_flag " << *i << "\n";
+    }
+
+  std::string file = dir;
+  file += "/";
+  file += cmSystemTools::ComputeStringMD5(key.str().c_str());
+  file += ".txt";
+  return file;
+#else
+  (void)lang;
+  (void)source;
+  (void)defs;
+  (void)flags;
+  return "";
+#endif
+}
+
+//----------------------------------------------------------------------------
+bool cmCoreTryCompile::LoadCachedResult(std::string const& file, int& res,
+                                        std::string& output)
+{
+  // The first line holds the result, the rest the build output.
+  std::ifstream fin(file.c_str());
+  std::string line;
+  if(!fin || !cmSystemTools::GetLineFromStream(fin, line))
+    {
+    return false;
+    }
+  res = atoi(line.c_str());
+  output = "Result of this try_compile taken from ";
+  output += file;
+  output += "\n";
+  char buffer[4096];
+  while(fin)
+    {
+    fin.read(buffer, sizeof(buffer));
+    output.append(buffer, fin.gcount());
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void cmCoreTryCompile::StoreCachedResult(std::string const& file, int res,
+                                         std::string const& output)
+{
+  // Processes sharing the directory may store the same result at the
+  // same time; the stream replaces the file in one step.
+  cmSystemTools::MakeDirectory(cmSystemTools::GetFilenamePath(file).c_str());
+  cmGeneratedFileStream fout(file.c_str());
+  fout << res << "\n" << output;
+}
+
+//----------------------------------------------------------------------------
 void cmCoreTryCompile::CleanupFiles(const char* binDir)
 {
   if ( !binDir )
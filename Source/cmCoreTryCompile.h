@@ -33,9 +33,30 @@ public:
   /**
    * This is the core code for try compile. It is here so that other
    * commands, such as TryRun can access the same logic without
-   * duplication. 
+   * duplication.  If cacheResult is true the result of a srcfile
+   * signature may come from the persistent result cache, in which
+   * case nothing is built.
    */
-  int TryCompileCode(std::vector<std::string> const& argv);
+  int TryCompileCode(std::vector<std::string> const& argv,
+                     bool cacheResult = false);
+
+  /**
+   * This is the core code for the BATCH signature of try_compile.  It
+   * builds an executable from every source file in one project and
+   * sets the result variable of each to whether it could be built.
+   */
+  int TryCompileBatch(std::vector<std::string> const& argv);
+
+  /**
+   * Build the executable of a srcfile signature by running the compile
+   * and link rules of its language directly instead of generating and
+   * building a project.  Returns false without doing anything if the
+   * project could build it with other commands than computed here.
+   */
+  bool TryCompileDirect(const char* lang, std::string const& source,
+                        std::vector<std::string> const& defs,
+                        std::vector<std::string> const& cmakeFlags,
+                        int& res, std::string& output);
 
   /** 
    * This deletes all the files created by TryCompileCode. 
@@ -51,6 +72,38 @@ public:
    */
   void FindOutputFile(const char* targetName);
 
+  /**
+   * Get the language of the source file of a srcfile signature.  If
+   * it is not an enabled language report an error and return 0.
+   */
+  const char* GetSourceLanguage(std::string const& source);
+
+  /**
+   * Write the commands of the CMakeLists.txt file of a srcfile
+   * signature that come before its targets.
+   */
+  void WriteProjectHeader(FILE* fout, std::vector<std::string> const& langs,
+                          std::vector<std::string> const& defs);
+
+  /** Add the cache entries every srcfile signature project gets.  */
+  void AddSourceFileCMakeFlags(std::vector<std::string>& cmakeFlags);
+
+  /**
+   * Compute the file holding the result of a srcfile signature build
+   * in the directory named by CMAKE_TRY_COMPILE_CACHE_DIR.  The name
+   * is a hash of everything the build depends on that CMake knows
+   * of.  Returns an empty string if the cache is not enabled.
+   */
+  std::string GetResultCacheFile(const char* lang, std::string const& source,
+                                 std::vector<std::string> const& defs,
+                                 std::vector<std::string> const& cmakeFlags);
+
+  /** Load or store a result in the persistent result cache.  */
+  bool LoadCachedResult(std::string const& file, int& res,
+                        std::string& output);
+  void StoreCachedResult(std::string const& file, int res,
+                         std::string const& output);
+
   
   cmTypeMacro(cmCoreTryCompile, cmCommand);
   
@@ -0,0 +1,264 @@
+/*=========================================================================
+
+  Program:   CMake - Cross-Platform Makefile Generator
+  Module:    $RCSfile: cmDefinitions.cxx,v $
+  Language:  C++
+  Date:      $Date: 2008/06/05 16:40:12 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) 2002 Kitware, Inc., Insight Consortium.  All rights reserved.
+  See Copyright.txt or http://www.cmake.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "cmDefinitions.h"
+
+#include "cmSystemTools.h"
+
+//----------------------------------------------------------------------------
+cmDefinitions::Def cmDefinitions::NoDef;
+
+//----------------------------------------------------------------------------
+cmDefinitions::cmDefinitions(cmDefinitions* parent): Up(parent)
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // Most nested scopes touch only a few variables.
+  , Map(parent? 16 : 1024)
+#endif
+{
+}
+
+//----------------------------------------------------------------------------
+void cmDefinitions::Reset(cmDefinitions* parent)
+{
+  this->Up = parent;
+  this->Map.clear();
+}
+
+//----------------------------------------------------------------------------
+cmDefinitions::Def const&
+cmDefinitions::GetInternal(const char* key) const
+{
+  MapType::const_iterator i = this->Map.find(key);
+  if(i != this->Map.end())
+    {
+    return i->second;
+    }
+  else if(cmDefinitions* up = this->Up)
+    {
+    // Query the parent scope and store the result locally.
+    Def def = up->GetInternal(key);
+    return this->Map.insert(MapType::value_type(key, def)).first->second;
+    }
+  return this->NoDef;
+}
+
+//----------------------------------------------------------------------------
+cmDefinitions::Def const&
+cmDefinitions::SetInternal(const char* key, Def const& def)
+{
+  if(this->Up || def.Exists)
+    {
+    // In lower scopes we store keys, defined or not.
+    MapType::iterator i = this->Map.find(key);
+    if(i == this->Map.end())
+      {
+      i = this->Map.insert(MapType::value_type(key, def)).first;
+      }
+    else
+      {
+      i->second = def;
+      }
+    return i->second;
+    }
+  else
+    {
+    // In the top-most scope we need not store undefined keys.
+    this->Map.erase(key);
+    return this->NoDef;
+    }
+}
+
+//----------------------------------------------------------------------------
+const char* cmDefinitions::Get(const char* key) const
+{
+  Def const& def = this->GetInternal(key);
+  return def.Exists? def.c_str() : 0;
+}
+
+//----------------------------------------------------------------------------
+const char* cmDefinitions::Set(const char* key, const char* value)
+{
+  Def const& def = this->SetInternal(key, Def(value));
+  return def.Exists? def.c_str() : 0;
+}
+
+//----------------------------------------------------------------------------
+bool cmDefinitions::ListEndsClean(const char* value)
+{
+  // Follow the escapes and square brackets the way
+  // cmSystemTools::ExpandListArgument does.
+  int squareNesting = 0;
+  for(const char* c = value; *c; ++c)
+    {
+    switch(*c)
+      {
+      case '\\':
+        if(!*++c)
+          {
+          // A trailing backslash would escape the next separator.
+          return false;
+          }
+        break;
+      case '[': ++squareNesting; break;
+      case ']': --squareNesting; break;
+      default: break;
+      }
+    }
+  return squareNesting == 0;
+}
+
+//----------------------------------------------------------------------------
+const char* cmDefinitions::Append(const char* key, const char* element)
+{
+  // Pull the value into this scope first, then update it in place.
+  if(!this->GetInternal(key).Exists)
+    {
+    return this->Set(key, element);
+    }
+  Def& def = this->Map.find(key)->second;
+  if(!def.empty())
+    {
+    def += ";";
+    }
+  def += element;
+
+  // A split that ends clean continues with the split of the element.
+  if(def.ListValid)
+    {
+    if(def.ListClean)
+      {
+      cmSystemTools::ExpandListArgument(element, def.List);
+      def.ListClean = cmDefinitions::ListEndsClean(element);
+      }
+    else
+      {
+      def.List.clear();
+      def.ListValid = false;
+      }
+    }
+  return def.c_str();
+}
+
+//----------------------------------------------------------------------------
+std::vector<std::string> const* cmDefinitions::GetList(const char* key) const
+{
+  Def const& def = this->GetInternal(key);
+  if(!def.Exists)
+    {
+    return 0;
+    }
+  if(!def.ListValid)
+    {
+    def.List.clear();
+    cmSystemTools::ExpandListArgument(def, def.List);
+    def.ListClean = cmDefinitions::ListEndsClean(def.c_str());
+    def.ListValid = true;
+    }
+  return &def.List;
+}
+
+//----------------------------------------------------------------------------
+std::set<cmStdString> cmDefinitions::LocalKeys() const
+{
+  std::set<cmStdString> keys;
+  // Consider local definitions.
+  for(MapType::const_iterator mi = this->Map.begin();
+      mi != this->Map.end(); ++mi)
+    {
+    if (mi->second.Exists)
+      {
+      keys.insert(mi->first);
+      }
+    }
+  return keys;
+}
+
+//----------------------------------------------------------------------------
+cmDefinitions cmDefinitions::Closure() const
+{
+  return cmDefinitions(ClosureTag(), this);
+}
+
+//----------------------------------------------------------------------------
+cmDefinitions::cmDefinitions(ClosureTag const&, cmDefinitions const* root):
+  Up(0)
+{
+  std::set<cmStdString> undefined;
+  this->ClosureImpl(undefined, root);
+}
+
+//----------------------------------------------------------------------------
+void cmDefinitions::ClosureImpl(std::set<cmStdString>& undefined,
+                                cmDefinitions const* defs)
+{
+  // Consider local definitions.
+  for(MapType::const_iterator mi = defs->Map.begin();
+      mi != defs->Map.end(); ++mi)
+    {
+    // Use this key if it is not already set or unset.
+    if(this->Map.find(mi->first) == this->Map.end() &&
+       undefined.find(mi->first) == undefined.end())
+      {
+      if(mi->second.Exists)
+        {
+        this->Map.insert(*mi);
+        }
+      else
+        {
+        undefined.insert(mi->first);
+        }
+      }
+    }
+
+  // Traverse parents.
+  if(cmDefinitions const* up = defs->Up)
+    {
+    this->ClosureImpl(undefined, up);
+    }
+}
+
+//----------------------------------------------------------------------------
+std::set<cmStdString> cmDefinitions::ClosureKeys() const
+{
+  std::set<cmStdString> defined;
+  std::set<cmStdString> undefined;
+  this->ClosureKeys(defined, undefined);
+  return defined;
+}
+
+//----------------------------------------------------------------------------
+void cmDefinitions::ClosureKeys(std::set<cmStdString>& defined,
+                                std::set<cmStdString>& undefined) const
+{
+  // Consider local definitions.
+  for(MapType::const_iterator mi = this->Map.begin();
+      mi != this->Map.end(); ++mi)
+    {
+    // Use this key if it is not already set or unset.
+    if(defined.find(mi->first) == defined.end() &&
+       undefined.find(mi->first) == undefined.end())
+      {
+      std::set<cmStdString>& m = mi->second.Exists? defined : undefined;
+      m.insert(mi->first);
+      }
+    }
+
+  // Traverse parents.
+  if(cmDefinitions const* up = this->Up)
+    {
+    up->ClosureKeys(defined, undefined);
+    }
+}
@@ -0,0 +1,134 @@
+/*=========================================================================
+
+  Program:   CMake - Cross-Platform Makefile Generator
+  Module:    $RCSfile: cmDefinitions.h,v $
+  Language:  C++
+  Date:      $Date: 2008/06/05 16:40:12 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) 2002 Kitware, Inc., Insight Consortium.  All rights reserved.
+  See Copyright.txt or http://www.cmake.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef cmDefinitions_h
+#define cmDefinitions_h
+
+#include "cmStandardIncludes.h"
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+# include <cmsys/hash_map.hxx>
+#endif
+
+/** \class cmDefinitions
+ * \brief Store a scope of variable definitions for CMake language.
+ *
+ * This stores the state of variable definitions (set or unset) for
+ * one scope.  Sets are always local.  Gets search parent scopes
+ * transitively and save results locally, so a new scope costs nothing
+ * to create and only the variables it touches are copied into it.
+ *
+ * A value may also be used as a list.  Its split into elements is
+ * kept with the value and extended in place by Append, so a list
+ * built one element at a time costs amortized constant time per
+ * element instead of a split and join of the whole value.
+ */
+class cmDefinitions
+{
+public:
+  /** Construct with the given parent scope.  */
+  cmDefinitions(cmDefinitions* parent = 0);
+
+  /** Reset object as if newly constructed.  */
+  void Reset(cmDefinitions* parent = 0);
+
+  /** Returns the parent scope, if any.  */
+  cmDefinitions* GetParent() const { return this->Up; }
+
+  /** Get the value associated with a key; null if none.
+      Store the result locally if it came from a parent.  */
+  const char* Get(const char* key) const;
+
+  /** Set (or unset if null) a value associated with a key.  */
+  const char* Set(const char* key, const char* value);
+
+  /** Append an element to the value of a key the way list(APPEND)
+      does, defining the key if needed.  Returns the new value.  */
+  const char* Append(const char* key, const char* element);
+
+  /** Get the value of a key split into list elements as by
+      cmSystemTools::ExpandListArgument; null if none.  */
+  std::vector<std::string> const* GetList(const char* key) const;
+
+  /** Get the set of all local keys.  */
+  std::set<cmStdString> LocalKeys() const;
+
+  /** Compute the closure of all defined keys with values.
+      This flattens the scope.  The result has no parent.  */
+  cmDefinitions Closure() const;
+
+  /** Compute the set of all defined keys.  */
+  std::set<cmStdString> ClosureKeys() const;
+
+private:
+  // String with existence boolean and the cached split into list
+  // elements, which is valid only if ListValid is set.  If ListClean
+  // is set the split ends outside of square brackets and escapes, so
+  // appending more elements cannot change the ones already split.
+  struct Def: public cmStdString
+  {
+    Def(): cmStdString(), Exists(false), ListValid(false),
+           ListClean(false) {}
+    Def(const char* v): cmStdString(v?v:""), Exists(v?true:false),
+                        ListValid(false), ListClean(false) {}
+    Def(Def const& d): cmStdString(d), Exists(d.Exists), List(d.List),
+                       ListValid(d.ListValid), ListClean(d.ListClean) {}
+    bool Exists;
+    mutable std::vector<std::string> List;
+    mutable bool ListValid;
+    mutable bool ListClean;
+  };
+  static Def NoDef;
+
+  // Parent scope, if any.
+  cmDefinitions* Up;
+
+  // Local definitions, set or unset.  Lookups from parent scopes are
+  // remembered here, so the map is mutable.  Key order does not matter
+  // because the key queries return sorted sets.
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  class HashString
+    {
+  public:
+    size_t operator()(const cmStdString& s) const
+      {
+      return h(s.c_str());
+      }
+    cmsys::hash<const char*> h;
+    };
+  typedef cmsys::hash_map<cmStdString, Def, HashString> MapType;
+#else
+  typedef std::map<cmStdString, Def> MapType;
+#endif
+  mutable MapType Map;
+
+  // Internal query and update methods.
+  Def const& GetInternal(const char* key) const;
+  Def const& SetInternal(const char* key, Def const& def);
+  static bool ListEndsClean(const char* value);
+
+  // Implementation of Closure() method.
+  struct ClosureTag {};
+  cmDefinitions(ClosureTag const&, cmDefinitions const* root);
+  void ClosureImpl(std::set<cmStdString>& undefined,
+                   cmDefinitions const* defs);
+
+  // Implementation of ClosureKeys() method.
+  void ClosureKeys(std::set<cmStdString>& defined,
+                   std::set<cmStdString>& undefined) const;
+};
+
+#endif
@@ -54,6 +54,8 @@ bool cmDepends::Write(std::ostream &makeDepends,
   std::vector<std::string> pairs;
   cmSystemTools::ExpandListArgument(srcStr, pairs);
 
+  std::vector<std::string> sources;
+  std::vector<std::string> objects;
   for(std::vector<std::string>::iterator si = pairs.begin();
       si != pairs.end();)
     {
@@ -67,15 +69,35 @@ bool cmDepends::Write(std::ostream &makeDepends,
                                         cmLocalGenerator::HOME_OUTPUT,
                                         cmLocalGenerator::MAKEFILE);
 
-    // Write the dependencies for this pair.
-    if(!this->WriteDependencies(src.c_str(), obj.c_str(),
+    sources.push_back(src);
+    objects.push_back(obj);
+    }
+
+  if(!this->WriteAllDependencies(sources, objects,
+                                 makeDepends, internalDepends))
+    {
+    return false;
+    }
+
+  return this->Finalize(makeDepends, internalDepends);
+}
+
+//----------------------------------------------------------------------------
+bool cmDepends::WriteAllDependencies(std::vector<std::string> const& sources,
+                                     std::vector<std::string> const& objects,
+                                     std::ostream& makeDepends,
+                                     std::ostream& internalDepends)
+{
+  // Write the dependencies for each pair.
+  for(std::vector<std::string>::size_type i = 0; i < sources.size(); ++i)
+    {
+    if(!this->WriteDependencies(sources[i].c_str(), objects[i].c_str(),
                                 makeDepends, internalDepends))
       {
       return false;
       }
     }
-
-  return this->Finalize(makeDepends, internalDepends);
+  return true;
 }
 
 //----------------------------------------------------------------------------
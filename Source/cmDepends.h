@@ -80,6 +80,14 @@ protected:
   virtual bool WriteDependencies(const char *src, const char* obj,
     std::ostream& makeDepends, std::ostream& internalDepends);
 
+  // Write dependencies for every pair of source and object file given.
+  // The default implementation calls WriteDependencies for each pair
+  // in order.
+  virtual bool WriteAllDependencies(std::vector<std::string> const& sources,
+                                    std::vector<std::string> const& objects,
+                                    std::ostream& makeDepends,
+                                    std::ostream& internalDepends);
+
   // Check dependencies for the target file in the given stream.
   // Return false if dependencies must be regenerated and true
   // otherwise.
@@ -22,17 +22,37 @@
 
 #include <ctype.h> // isspace
 
-
+#if defined(_WIN32) && !defined(__CYGWIN__)
+# define CM_DEPENDS_C_USE_MMAP 0
+#else
+# define CM_DEPENDS_C_USE_MMAP 1
+# include <sys/types.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+#if defined(CMAKE_USE_PTHREADS)
+# include <pthread.h>
+#endif
+
+
+// The scanner does not evaluate this expression but matches the same
+// lines by hand, see cmDependsCMatchInclude.  It is still recorded in
+// the cache file so that a change of the rules invalidates the cache.
 #define INCLUDE_REGEX_LINE \
   "^[ \t]*#[ \t]*(include|import)[ \t]*[<\"]([^\">]+)([\">])"
 
+#define INCLUDE_REGEX_SCAN_ALL "^.*$"
+
 #define INCLUDE_REGEX_LINE_MARKER "#IncludeRegexLine: "
 #define INCLUDE_REGEX_SCAN_MARKER "#IncludeRegexScan: "
 #define INCLUDE_REGEX_COMPLAIN_MARKER "#IncludeRegexComplain: "
 
 //----------------------------------------------------------------------------
 cmDependsC::cmDependsC():
-  IncludePath(0)
+  IncludePath(0), IncludeRegexScanAll(false), CacheMutex(0), ScanJobs(1)
 {
 }
 //----------------------------------------------------------------------------
@@ -41,15 +61,19 @@ cmDependsC::cmDependsC(std::vector<std::string> const& includes,
                        const char* scanRegex, const char* complainRegex,
                        const cmStdString& cacheFileName):
   IncludePath(&includes),
-  IncludeRegexLine(INCLUDE_REGEX_LINE),
   IncludeRegexScan(scanRegex),
   IncludeRegexComplain(complainRegex),
   IncludeRegexLineString(INCLUDE_REGEX_LINE_MARKER INCLUDE_REGEX_LINE),
   IncludeRegexScanString(std::string(INCLUDE_REGEX_SCAN_MARKER)+scanRegex),
   IncludeRegexComplainString(
     std::string(INCLUDE_REGEX_COMPLAIN_MARKER)+complainRegex),
+  CacheMutex(0),
+  ScanJobs(cmSystemTools::GetNumberOfProcessors()),
   CacheFileName(cacheFileName)
 {
+  // The default expression accepts every file name so do not bother
+  // evaluating it for each include.
+  this->IncludeRegexScanAll = strcmp(scanRegex, INCLUDE_REGEX_SCAN_ALL) == 0;
   this->ReadCacheFile();
 }
 
@@ -65,6 +89,318 @@ cmDependsC::~cmDependsC()
     }
 }
 
+//----------------------------------------------------------------------------
+// Read-only view of the whole content of a file.  Where the platform
+// supports it the file is mapped into memory, otherwise it is read
+// into the buffer given to the constructor.
+class cmDependsCFileContent
+{
+public:
+  cmDependsCFileContent(std::vector<char>& buffer):
+    Begin(0), End(0), Buffer(buffer), Mapped(0), MappedLength(0) {}
+  ~cmDependsCFileContent()
+    {
+#if CM_DEPENDS_C_USE_MMAP
+    if(this->Mapped)
+      {
+      munmap(this->Mapped, this->MappedLength);
+      }
+#endif
+    }
+
+  bool Load(const char* fname)
+    {
+#if CM_DEPENDS_C_USE_MMAP
+    int fd = open(fname, O_RDONLY);
+    if(fd < 0)
+      {
+      return false;
+      }
+    struct stat st;
+    if(fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+      {
+      if(st.st_size == 0)
+        {
+        close(fd);
+        return true;
+        }
+      void* p = mmap(0, static_cast<size_t>(st.st_size), PROT_READ,
+                     MAP_PRIVATE, fd, 0);
+      if(p != MAP_FAILED)
+        {
+        close(fd);
+        this->Mapped = p;
+        this->MappedLength = static_cast<size_t>(st.st_size);
+        this->Begin = static_cast<const char*>(p);
+        this->End = this->Begin + this->MappedLength;
+        return true;
+        }
+      }
+    close(fd);
+#endif
+    return this->Read(fname);
+    }
+
+  const char* Begin;
+  const char* End;
+private:
+  bool Read(const char* fname)
+    {
+    std::ifstream fin(fname, std::ios::in | std::ios::binary);
+    if(!fin)
+      {
+      return false;
+      }
+    this->Buffer.clear();
+    char buf[16384];
+    while(fin.read(buf, sizeof(buf)), fin.gcount() > 0)
+      {
+      this->Buffer.insert(this->Buffer.end(), buf, buf + fin.gcount());
+      }
+    if(!this->Buffer.empty())
+      {
+      this->Begin = &this->Buffer[0];
+      this->End = this->Begin + this->Buffer.size();
+      }
+    return true;
+    }
+
+  std::vector<char>& Buffer;
+  void* Mapped;
+  size_t MappedLength;
+};
+
+//----------------------------------------------------------------------------
+// Match the include directive whose '#' is at hash, accepting exactly
+// the lines matched by INCLUDE_REGEX_LINE.  On success the name
+// included is [nameBegin, nameEnd) and nameEnd points at the closing
+// delimiter.
+static bool cmDependsCMatchInclude(const char* begin, const char* hash,
+                                   const char* end, const char*& nameBegin,
+                                   const char*& nameEnd)
+{
+  // Only blanks may precede the '#' on its line.
+  const char* p = hash;
+  while(p > begin && (p[-1] == ' ' || p[-1] == '\t'))
+    {
+    --p;
+    }
+  if(p > begin && p[-1] != '\n')
+    {
+    return false;
+    }
+
+  // Look for the directive name.
+  p = hash + 1;
+  while(p < end && (*p == ' ' || *p == '\t'))
+    {
+    ++p;
+    }
+  if(end - p >= 7 && strncmp(p, "include", 7) == 0)
+    {
+    p += 7;
+    }
+  else if(end - p >= 6 && strncmp(p, "import", 6) == 0)
+    {
+    p += 6;
+    }
+  else
+    {
+    return false;
+    }
+  while(p < end && (*p == ' ' || *p == '\t'))
+    {
+    ++p;
+    }
+  if(p == end || (*p != '<' && *p != '"'))
+    {
+    return false;
+    }
+
+  // The name extends to the first delimiter of either kind and may
+  // not cross the end of the line.  The line was matched as a C string
+  // so a null character ends it too.
+  nameBegin = ++p;
+  while(p < end && *p != '"' && *p != '>' && *p != '\n' && *p != '\0')
+    {
+    ++p;
+    }
+  if(p == nameBegin || p == end || (*p != '"' && *p != '>'))
+    {
+    return false;
+    }
+  nameEnd = p;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Mutex for the data shared by threads scanning dependencies.  Without
+// thread support nothing is shared and it does nothing.
+class cmDependsCMutex
+{
+public:
+#if defined(CMAKE_USE_PTHREADS)
+  cmDependsCMutex() { pthread_mutex_init(&this->Mutex, 0); }
+  ~cmDependsCMutex() { pthread_mutex_destroy(&this->Mutex); }
+  void Lock() { pthread_mutex_lock(&this->Mutex); }
+  void Unlock() { pthread_mutex_unlock(&this->Mutex); }
+private:
+  pthread_mutex_t Mutex;
+#else
+  void Lock() {}
+  void Unlock() {}
+#endif
+};
+
+//----------------------------------------------------------------------------
+// Hold a mutex, if there is one, for the lifetime of the object.
+class cmDependsCLock
+{
+public:
+  cmDependsCLock(cmDependsCMutex* mutex): Mutex(mutex)
+    {
+    if(this->Mutex)
+      {
+      this->Mutex->Lock();
+      }
+    }
+  ~cmDependsCLock()
+    {
+    if(this->Mutex)
+      {
+      this->Mutex->Unlock();
+      }
+    }
+private:
+  cmDependsCMutex* Mutex;
+};
+
+#if defined(CMAKE_USE_PTHREADS)
+//----------------------------------------------------------------------------
+// Pool of threads scanning the dependencies of several sources.  Each
+// thread takes the next source not taken yet until none is left.
+class cmDependsCScanThreads
+{
+public:
+  cmDependsCScanThreads(cmDependsC* scanner,
+                        std::vector<std::string> const& sources):
+    Dependencies(sources.size()), Missing(sources.size()),
+    Scanner(scanner), Sources(sources), Next(0), Failed(false) {}
+
+  // Scan all sources with up to the given number of threads, including
+  // the calling one.
+  void Run(unsigned int jobs);
+  void Work();
+
+  // The results of each source.  Missing is the name of the file that
+  // could not be found for the sources whose scan failed.
+  std::vector< std::set<cmStdString> > Dependencies;
+  std::vector<std::string> Missing;
+private:
+  cmDependsC* Scanner;
+  std::vector<std::string> const& Sources;
+  std::vector<std::string>::size_type Next;
+  bool Failed;
+  cmDependsCMutex Mutex;
+};
+
+extern "C" void* cmDependsCScanThreadMain(void* arg)
+{
+  static_cast<cmDependsCScanThreads*>(arg)->Work();
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+void cmDependsCScanThreads::Run(unsigned int jobs)
+{
+  // If a thread cannot be created the others do its share.
+  std::vector<pthread_t> threads;
+  for(unsigned int i = 1; i < jobs; ++i)
+    {
+    pthread_t thread;
+    if(pthread_create(&thread, 0, cmDependsCScanThreadMain, this) != 0)
+      {
+      break;
+      }
+    threads.push_back(thread);
+    }
+  this->Work();
+  for(std::vector<pthread_t>::iterator i = threads.begin();
+      i != threads.end(); ++i)
+    {
+    pthread_join(*i, 0);
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmDependsCScanThreads::Work()
+{
+  cmDependsC::WalkState walk;
+  for(;;)
+    {
+    // Sources are taken in order so after a failure the sources before
+    // it are all scanned, as they are when scanning one at a time.
+    std::vector<std::string>::size_type i;
+    {
+    cmDependsCLock lock(&this->Mutex);
+    if(this->Failed || this->Next == this->Sources.size())
+      {
+      return;
+      }
+    i = this->Next++;
+    }
+    if(!this->Scanner->ScanDependencies(this->Sources[i].c_str(), walk,
+                                        this->Dependencies[i],
+                                        this->Missing[i]))
+      {
+      cmDependsCLock lock(&this->Mutex);
+      this->Failed = true;
+      }
+    }
+}
+#endif
+
+//----------------------------------------------------------------------------
+bool cmDependsC::WriteAllDependencies(std::vector<std::string> const& sources,
+                                      std::vector<std::string> const& objects,
+                                      std::ostream& makeDepends,
+                                      std::ostream& internalDepends)
+{
+#if defined(CMAKE_USE_PTHREADS)
+  unsigned int jobs = this->ScanJobs;
+  if(jobs > sources.size())
+    {
+    jobs = static_cast<unsigned int>(sources.size());
+    }
+  if(jobs > 1 && this->IncludePath)
+    {
+    // Scan all the sources first, several at once, and then write
+    // their dependencies in order.
+    cmDependsCMutex mutex;
+    this->CacheMutex = &mutex;
+    cmDependsCScanThreads threads(this, sources);
+    threads.Run(jobs);
+    this->CacheMutex = 0;
+
+    for(std::vector<std::string>::size_type i = 0; i < sources.size(); ++i)
+      {
+      if(!threads.Missing[i].empty())
+        {
+        cmSystemTools::Error("Cannot find file \"",
+                             threads.Missing[i].c_str(), "\".");
+        return false;
+        }
+      this->WriteObjectDependencies(objects[i].c_str(),
+                                    threads.Dependencies[i],
+                                    makeDepends, internalDepends);
+      }
+    return true;
+    }
+#endif
+  return this->cmDepends::WriteAllDependencies(sources, objects,
+                                               makeDepends, internalDepends);
+}
+
 //----------------------------------------------------------------------------
 bool cmDependsC::WriteDependencies(const char *src, const char *obj,
   std::ostream& makeDepends, std::ostream& internalDepends)
@@ -86,28 +422,45 @@ bool cmDependsC::WriteDependencies(const char *src, const char *obj,
     return false;
     }
 
+  WalkState walk;
+  std::set<cmStdString> dependencies;
+  std::string missing;
+  if(!this->ScanDependencies(src, walk, dependencies, missing))
+    {
+    cmSystemTools::Error("Cannot find file \"", missing.c_str(), "\".");
+    return false;
+    }
+  this->WriteObjectDependencies(obj, dependencies,
+                                makeDepends, internalDepends);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool cmDependsC::ScanDependencies(const char* src, WalkState& walk,
+                                  std::set<cmStdString>& dependencies,
+                                  std::string& missing)
+{
   // Walk the dependency graph starting with the source file.
   bool first = true;
   UnscannedEntry root;
   root.FileName = src;
-  this->Unscanned.push(root);
-  this->Encountered.clear();
-  this->Encountered.insert(src);
-  std::set<cmStdString> dependencies;
+  walk.Unscanned.push(root);
+  walk.Encountered.clear();
+  walk.Encountered.insert(src);
   std::set<cmStdString> scanned;
 
   // Use reserve to allocate enough memory for both strings,
   // so that during the loops no memory is allocated or freed
-  std::string cacheKey;
+  std::string& cacheKey = walk.CacheKey;
   cacheKey.reserve(4*1024);
-  std::string tempPathStr;
+  std::string& tempPathStr = walk.TempPath;
   tempPathStr.reserve(4*1024);
 
-  while(!this->Unscanned.empty())
+  while(!walk.Unscanned.empty())
     {
     // Get the next file to scan.
-    UnscannedEntry current = this->Unscanned.front();
-    this->Unscanned.pop();
+    UnscannedEntry current = walk.Unscanned.front();
+    walk.Unscanned.pop();
 
     // If not a full path, find the file in the include path.
     std::string fullName;
@@ -142,13 +495,18 @@ bool cmDependsC::WriteDependencies(const char *src, const char *obj,
         {
         cacheKey+=*i;
         }
+      bool cached = false;
+      {
+      cmDependsCLock lock(this->CacheMutex);
       std::map<cmStdString, cmStdString>::iterator
         headerLocationIt=this->HeaderLocationCache.find(cacheKey);
       if (headerLocationIt!=this->HeaderLocationCache.end())
         {
         fullName=headerLocationIt->second;
+        cached = true;
         }
-      else for(std::vector<std::string>::const_iterator i =
+      }
+      if(!cached) for(std::vector<std::string>::const_iterator i =
             this->IncludePath->begin(); i != this->IncludePath->end(); ++i)
         {
         // Construct the name of the file as if it were in the current
@@ -170,6 +528,7 @@ bool cmDependsC::WriteDependencies(const char *src, const char *obj,
         if(cmSystemTools::FileExists(tempPathStr.c_str(), true))
           {
             fullName = tempPathStr;
+            cmDependsCLock lock(this->CacheMutex);
             HeaderLocationCache[cacheKey]=fullName;
           break;
           }
@@ -179,10 +538,9 @@ bool cmDependsC::WriteDependencies(const char *src, const char *obj,
     // Complain if the file cannot be found and matches the complain
     // regex.
     if(fullName.empty() &&
-       this->IncludeRegexComplain.find(current.FileName.c_str()))
+       this->FindRegex(this->IncludeRegexComplain, current.FileName.c_str()))
       {
-      cmSystemTools::Error("Cannot find file \"",
-                           current.FileName.c_str(), "\".");
+      missing = current.FileName;
       return false;
       }
 
@@ -192,22 +550,32 @@ bool cmDependsC::WriteDependencies(const char *src, const char *obj,
       // Record scanned files.
       scanned.insert(fullName);
 
-      // Check whether this file is already in the cache
+      // Check whether this file is already in the cache.  Apart from
+      // the Used flag entries are not modified once they are in the
+      // cache so their includes can be read without holding the lock.
+      cmIncludeLines* cacheEntry = 0;
+      {
+      cmDependsCLock lock(this->CacheMutex);
       std::map<cmStdString, cmIncludeLines*>::iterator fileIt=
         this->FileCache.find(fullName);
       if (fileIt!=this->FileCache.end())
         {
         fileIt->second->Used=true;
+        cacheEntry = fileIt->second;
+        }
+      }
+      if (cacheEntry)
+        {
         dependencies.insert(fullName);
         for (std::vector<UnscannedEntry>::const_iterator incIt=
-               fileIt->second->UnscannedEntries.begin(); 
-             incIt!=fileIt->second->UnscannedEntries.end(); ++incIt)
+               cacheEntry->UnscannedEntries.begin(); 
+             incIt!=cacheEntry->UnscannedEntries.end(); ++incIt)
           {
-          if (this->Encountered.find(incIt->FileName) == 
-              this->Encountered.end())
+          if (walk.Encountered.find(incIt->FileName) == 
+              walk.Encountered.end())
             {
-            this->Encountered.insert(incIt->FileName);
-            this->Unscanned.push(*incIt);
+            walk.Encountered.insert(incIt->FileName);
+            walk.Unscanned.push(*incIt);
             }
           }
         }
@@ -216,8 +584,8 @@ bool cmDependsC::WriteDependencies(const char *src, const char *obj,
 
         // Try to scan the file.  Just leave it out if we cannot find
         // it.
-        std::ifstream fin(fullName.c_str());
-        if(fin)
+        cmDependsCFileContent content(walk.Buffer);
+        if(content.Load(fullName.c_str()))
           {
           // Add this file as a dependency.
           dependencies.insert(fullName);
@@ -225,7 +593,8 @@ bool cmDependsC::WriteDependencies(const char *src, const char *obj,
           // Scan this file for new dependencies.  Pass the directory
           // containing the file to handle double-quote includes.
           std::string dir = cmSystemTools::GetFilenamePath(fullName);
-          this->Scan(fin, dir.c_str(), fullName);
+          this->Scan(content.Begin, content.End, dir.c_str(), fullName,
+                     walk);
           }
         }
       }
@@ -233,12 +602,20 @@ bool cmDependsC::WriteDependencies(const char *src, const char *obj,
     first = false;
     }
 
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void cmDependsC::WriteObjectDependencies(
+  const char* obj, std::set<cmStdString> const& dependencies,
+  std::ostream& makeDepends, std::ostream& internalDepends)
+{
   // Write the dependencies to the output stream.  Makefile rules
   // written by the original local generator for this directory
   // convert the dependencies to paths relative to the home output
   // directory.  We must do the same here.
   internalDepends << obj << std::endl;
-  for(std::set<cmStdString>::iterator i=dependencies.begin();
+  for(std::set<cmStdString>::const_iterator i=dependencies.begin();
       i != dependencies.end(); ++i)
     {
     makeDepends << obj << ": " << 
@@ -249,8 +626,6 @@ bool cmDependsC::WriteDependencies(const char *src, const char *obj,
     internalDepends << " " << i->c_str() << std::endl;
     }
   makeDepends << std::endl;
-
-  return true;
 }
 
 //----------------------------------------------------------------------------
@@ -380,50 +755,80 @@ void cmDependsC::WriteCacheFile() const
 }
 
 //----------------------------------------------------------------------------
-void cmDependsC::Scan(std::istream& is, const char* directory,
-  const cmStdString& fullName)
+void cmDependsC::Scan(const char* begin, const char* end,
+                      const char* directory, const cmStdString& fullName,
+                      WalkState& walk)
 {
   cmIncludeLines* newCacheEntry=new cmIncludeLines;
   newCacheEntry->Used=true;
-  this->FileCache[fullName]=newCacheEntry;
-  
-  // Read one line at a time.
-  std::string line;
-  while(cmSystemTools::GetLineFromStream(is, line))
+
+  // Jump from one '#' to the next rather than reading the file line
+  // by line.  Most lines contain no '#' at all.
+  const char* cur = begin;
+  const char* hash;
+  while(cur < end &&
+        (hash = static_cast<const char*>(memchr(cur, '#', end - cur))))
     {
-    // Match include directives.
-    if(this->IncludeRegexLine.find(line.c_str()))
+    const char* nameBegin;
+    const char* nameEnd;
+    if(!cmDependsCMatchInclude(begin, hash, end, nameBegin, nameEnd))
       {
-      // Get the file being included.
-      UnscannedEntry entry;
-      entry.FileName = this->IncludeRegexLine.match(2);
-      if(this->IncludeRegexLine.match(3) == "\"" &&
-         !cmSystemTools::FileIsFullPath(entry.FileName.c_str()))
-        {
-        // This was a double-quoted include with a relative path.  We
-        // must check for the file in the directory containing the
-        // file we are scanning.
-        entry.QuotedLocation = directory;
-        entry.QuotedLocation += "/";
-        entry.QuotedLocation += entry.FileName;
-        }
+      cur = hash + 1;
+      continue;
+      }
+    cur = nameEnd + 1;
 
-      // Queue the file if it has not yet been encountered and it
-      // matches the regular expression for recursive scanning.  Note
-      // that this check does not account for the possibility of two
-      // headers with the same name in different directories when one
-      // is included by double-quotes and the other by angle brackets.
-      // This kind of problem will be fixed when a more
-      // preprocessor-like implementation of this scanner is created.
-      if (this->IncludeRegexScan.find(entry.FileName.c_str()))
+    // Get the file being included.
+    UnscannedEntry entry;
+    entry.FileName.assign(nameBegin, nameEnd);
+    if(*nameEnd == '"' &&
+       !cmSystemTools::FileIsFullPath(entry.FileName.c_str()))
+      {
+      // This was a double-quoted include with a relative path.  We
+      // must check for the file in the directory containing the
+      // file we are scanning.
+      entry.QuotedLocation = directory;
+      entry.QuotedLocation += "/";
+      entry.QuotedLocation += entry.FileName;
+      }
+
+    // Queue the file if it has not yet been encountered and it
+    // matches the regular expression for recursive scanning.  Note
+    // that this check does not account for the possibility of two
+    // headers with the same name in different directories when one
+    // is included by double-quotes and the other by angle brackets.
+    // This kind of problem will be fixed when a more
+    // preprocessor-like implementation of this scanner is created.
+    if (this->IncludeRegexScanAll ||
+        this->FindRegex(this->IncludeRegexScan, entry.FileName.c_str()))
+      {
+      newCacheEntry->UnscannedEntries.push_back(entry);
+      if(walk.Encountered.find(entry.FileName) == walk.Encountered.end())
         {
-        newCacheEntry->UnscannedEntries.push_back(entry);
-        if(this->Encountered.find(entry.FileName) == this->Encountered.end())
-          {
-          this->Encountered.insert(entry.FileName);
-          this->Unscanned.push(entry);
-          }
+        walk.Encountered.insert(entry.FileName);
+        walk.Unscanned.push(entry);
         }
       }
     }
+
+  // Publish the complete entry.  Another thread may have scanned the
+  // same file meanwhile, in which case both entries are the same.
+  cmDependsCLock lock(this->CacheMutex);
+  cmIncludeLines*& cacheEntry = this->FileCache[fullName];
+  if(cacheEntry)
+    {
+    delete newCacheEntry;
+    }
+  else
+    {
+    cacheEntry = newCacheEntry;
+    }
+}
+
+//----------------------------------------------------------------------------
+bool cmDependsC::FindRegex(cmsys::RegularExpression& regex, const char* str)
+{
+  // The expression implementation keeps its state in static storage.
+  cmDependsCLock lock(this->CacheMutex);
+  return regex.find(str);
 }
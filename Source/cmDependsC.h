@@ -21,6 +21,8 @@
 #include <cmsys/RegularExpression.hxx>
 #include <queue>
 
+class cmDependsCMutex;
+
 /** \class cmDependsC
  * \brief Dependency scanner for C and C++ object files.
  */
@@ -37,6 +39,9 @@ public:
   /** Virtual destructor to cleanup subclasses properly.  */
   virtual ~cmDependsC();
 
+  /** Set the maximum number of threads scanning sources at once.  */
+  void SetScanJobs(unsigned int jobs) { this->ScanJobs = jobs; }
+
 protected:
   typedef std::vector<char> t_CharBuffer;
 
@@ -45,21 +50,19 @@ protected:
                                  const char *file,
                                  std::ostream& makeDepends,
                                  std::ostream& internalDepends);
-
-  // Method to scan a single file.
-  void Scan(std::istream& is, const char* directory,
-    const cmStdString& fullName);
+  virtual bool WriteAllDependencies(std::vector<std::string> const& sources,
+                                    std::vector<std::string> const& objects,
+                                    std::ostream& makeDepends,
+                                    std::ostream& internalDepends);
 
   // The include file search path.
   std::vector<std::string> const* IncludePath;
 
-  // Regular expression to identify C preprocessor include directives.
-  cmsys::RegularExpression IncludeRegexLine;
-
   // Regular expressions to choose which include files to scan
   // recursively and which to complain about not finding.
   cmsys::RegularExpression IncludeRegexScan;
   cmsys::RegularExpression IncludeRegexComplain;
+  bool IncludeRegexScanAll;
   const std::string IncludeRegexLineString;
   const std::string IncludeRegexScanString;
   const std::string IncludeRegexComplainString;
@@ -79,18 +82,52 @@ public:
     bool Used;
   };
 protected:
-  std::set<cmStdString> Encountered;
-  std::queue<UnscannedEntry> Unscanned;
-  t_CharBuffer Buffer;
+  // State of the walk through the dependency graph of one source.
+  // Threads scanning different sources each have their own.
+  struct WalkState
+  {
+    std::set<cmStdString> Encountered;
+    std::queue<UnscannedEntry> Unscanned;
+    t_CharBuffer Buffer;
+    std::string CacheKey;
+    std::string TempPath;
+  };
 
+  // Find the files the source depends on.  If a file matching the
+  // complain expression cannot be found its name is stored in missing
+  // and false is returned.
+  bool ScanDependencies(const char* src, WalkState& walk,
+                        std::set<cmStdString>& dependencies,
+                        std::string& missing);
+
+  // Method to scan the content [begin, end) of a single file.
+  void Scan(const char* begin, const char* end, const char* directory,
+            const cmStdString& fullName, WalkState& walk);
+
+  // Evaluate one of the expressions.  This is safe while several
+  // threads scan sources.
+  bool FindRegex(cmsys::RegularExpression& regex, const char* str);
+
+  // Write the dependencies found for one object file.
+  void WriteObjectDependencies(const char* obj,
+                               std::set<cmStdString> const& dependencies,
+                               std::ostream& makeDepends,
+                               std::ostream& internalDepends);
+
+  // The caches are shared by all walks.  While several threads scan
+  // sources the mutex guards them, and the expressions, which cannot
+  // be evaluated concurrently.
   std::map<cmStdString, cmIncludeLines *> FileCache;
   std::map<cmStdString, cmStdString> HeaderLocationCache;
+  cmDependsCMutex* CacheMutex;
+  unsigned int ScanJobs;
 
   cmStdString CacheFileName;
 
   void WriteCacheFile() const;
   void ReadCacheFile();
 private:
+  friend class cmDependsCScanThreads;
   cmDependsC(cmDependsC const&); // Purposely not implemented.
   void operator=(cmDependsC const&); // Purposely not implemented.
 };
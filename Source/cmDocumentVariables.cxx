@@ -434,6 +434,106 @@ void cmDocumentVariables::DefineVariables(cmake* cm)
      " on UNIX and c:/Program Files on Windows.",false,
      "Variables That Change Behavior");
 
+  cm->DefineProperty
+    ("CMAKE_LUA_GC_PAUSE", cmProperty::VARIABLE,
+     "Pause of the Lua garbage collector.",
+     "Sets how long the incremental collector of the Lua state waits "
+     "before starting a new cycle, as a percentage of the memory in use "
+     "after the previous cycle.  The Lua default of 200 starts a cycle "
+     "when the heap has doubled; larger values trade memory for less "
+     "time spent collecting.  The value is read when the Lua state is "
+     "initialized, so set it in the cache.  See also "
+     "CMAKE_LUA_GC_STEPMUL.",
+     false,
+     "Variables That Change Behavior");
+
+  cm->DefineProperty
+    ("CMAKE_LUA_GC_STEPMUL", cmProperty::VARIABLE,
+     "Step multiplier of the Lua garbage collector.",
+     "Sets the speed of the incremental collector of the Lua state "
+     "relative to memory allocation, as a percentage.  The Lua default "
+     "is 200; smaller values make each step shorter but cycles longer.  "
+     "The value is read when the Lua state is initialized, like "
+     "CMAKE_LUA_GC_PAUSE.",false,
+     "Variables That Change Behavior");
+
+  cm->DefineProperty
+    ("CMAKE_COMPILE_LISTFILES", cmProperty::VARIABLE,
+     "Run listfiles and function bodies in compiled form.",
+     "If this variable is true, CMake lowers each listfile and function "
+     "body once into a flat list of instructions in which if, elseif, "
+     "else, while and foreach become jumps, and remembers the command "
+     "each line calls.  Loops then run without recording and replaying "
+     "their bodies.  Files using control flow that the compiler does not "
+     "understand, such as end commands whose arguments do not match, are "
+     "run one command at a time as usual.  The variable is checked when "
+     "a file is read or a function is called.",
+     false,
+     "Variables That Change Behavior");
+
+  cm->DefineProperty
+    ("CMAKE_PERSIST_LISTFILE_CACHE", cmProperty::VARIABLE,
+     "Keep parsed listfiles between runs.",
+     "During one run CMake parses each included listfile once and "
+     "reuses the result while the file is unchanged.  If this cache "
+     "entry is ON the parsed files are also saved in "
+     "CMakeFiles/ListFileCache.txt, so that the next configure does not "
+     "lex the modules that did not change.",
+     false,
+     "Variables That Change Behavior");
+
+  cm->DefineProperty
+    ("CMAKE_TRY_COMPILE_CACHE_DIR", cmProperty::VARIABLE,
+     "Directory keeping try_compile results between build trees.",
+     "If this variable or the environment variable of the same name "
+     "names a directory, try_compile stores the result and output of "
+     "each single source build there, under a hash of the source text, "
+     "its COMPILE_DEFINITIONS and CMAKE_FLAGS, the language flags and "
+     "the compiler.  A later try_compile with the same hash, in this or "
+     "any other build tree, takes the result from the directory instead "
+     "of building.  Headers and libraries found on the system are not "
+     "part of the hash, so remove the files after installing or "
+     "removing them.  try_run and try_compile with COPY_FILE always "
+     "build.",
+     false,
+     "Variables That Change Behavior");
+
+  cm->DefineProperty
+    ("CMAKE_TRY_COMPILE_DIRECT", cmProperty::VARIABLE,
+     "Set to OFF to always build a project for try_compile.",
+     "With the Unix Makefiles generator, try_compile and try_run of a C "
+     "or C++ srcfile run the compile and link rules of the language "
+     "directly when the project they generate would run the same "
+     "commands.  This is the case unless CMAKE_FLAGS set other "
+     "variables than COMPILE_DEFINITIONS, INCLUDE_DIRECTORIES and "
+     "CMAKE_SKIP_RPATH, libraries are linked, or the flags need "
+     "quoting.  Set this variable to OFF to generate and build the "
+     "project always.  --debug-trycompile does the same.",
+     false,
+     "Variables That Change Behavior");
+
+  cm->DefineProperty
+    ("CMAKE_TRY_COMPILE_BATCH_JOBS", cmProperty::VARIABLE,
+     "Number of jobs building the sources of a try_compile BATCH.",
+     "The executables of try_compile(BATCH ...) are built in parallel "
+     "by the make programs that can.  This variable limits the number "
+     "of jobs building them at the same time.  By default it is the "
+     "number of processors.",
+     false,
+     "Variables That Change Behavior");
+
+  cm->DefineProperty
+    ("CMAKE_DEPENDS_SCAN_JOBS", cmProperty::VARIABLE,
+     "Number of threads scanning C and C++ dependencies of a target.",
+     "The Makefile generators scan the implicit dependencies of the "
+     "sources of a target with several threads where the platform "
+     "supports them.  The value this variable has in a directory at "
+     "the end of its CMakeLists.txt limits the number of threads "
+     "scanning the targets of that directory.  By default it is the "
+     "number of processors.  Set it to 1 to scan one source at a time.",
+     false,
+     "Variables That Change Behavior");
+
   cm->DefineProperty
     ("CMAKE_MODULE_PATH", cmProperty::VARIABLE,
      "Path to look for cmake modules to load.",
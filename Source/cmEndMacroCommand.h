@@ -41,6 +41,7 @@ public:
    */
   virtual bool InvokeInitialPass(std::vector<cmListFileArgument> const&,
                                  cmExecutionStatus &);
+  virtual bool AcceptsDirectArguments() { return false; }
   
   /**
    * This is called when the command is first encountered in
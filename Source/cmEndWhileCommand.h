@@ -35,12 +35,18 @@ public:
     return new cmEndWhileCommand;
     }
 
+  /**
+   * This determines if one instance may run many invocations.
+   */
+  virtual bool IsReusable() { return true; }
+
   /**
    * Override cmCommand::InvokeInitialPass to get arguments before
    * expansion.
    */
   virtual bool InvokeInitialPass(std::vector<cmListFileArgument> const&,
                                  cmExecutionStatus &status);
+  virtual bool AcceptsDirectArguments() { return false; }
   
   /**
    * This is called when the command is first encountered in
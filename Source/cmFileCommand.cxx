@@ -18,6 +18,7 @@
 #include "cmake.h"
 #include "cmHexFileConverter.h"
 #include "cmFileTimeComparison.h"
+#include "cmRegularExpressionCache.h"
 
 #if defined(CMAKE_BUILD_WITH_CMAKE)
 #include "cm_curl.h"
@@ -142,6 +143,29 @@ bool cmFileCommand
   return false;
 }
 
+//----------------------------------------------------------------------------
+std::string
+cmFileCommand::GetLuaResultVariable(std::vector<std::string> const& args)
+{
+  if(args.size() < 2)
+    {
+    return std::string();
+    }
+  const std::string &subCommand = args[0];
+  if(subCommand == "GLOB" || subCommand == "GLOB_RECURSE" ||
+     subCommand == "RELATIVE_PATH")
+    {
+    return args[1];
+    }
+  if((subCommand == "READ" || subCommand == "STRINGS" ||
+      subCommand == "TO_CMAKE_PATH" || subCommand == "TO_NATIVE_PATH") &&
+     args.size() > 2)
+    {
+    return args[2];
+    }
+  return std::string();
+}
+
 //----------------------------------------------------------------------------
 bool cmFileCommand::HandleWriteCommand(std::vector<std::string> const& args,
   bool append)
@@ -367,7 +391,7 @@ bool cmFileCommand::HandleStringsCommand(std::vector<std::string> const& args)
   int limit_input = -1;
   int limit_output = -1;
   unsigned int limit_count = 0;
-  cmsys::RegularExpression regex;
+  cmsys::RegularExpression const* compiled = 0;
   bool have_regex = false;
   bool newline_consume = false;
   bool hex_conversion_enabled = true;
@@ -478,7 +502,8 @@ bool cmFileCommand::HandleStringsCommand(std::vector<std::string> const& args)
       }
     else if(arg_mode == arg_regex)
       {
-      if(!regex.compile(args[i].c_str()))
+      compiled = cmRegularExpressionCache::Get(args[i].c_str());
+      if(!compiled)
         {
         cmOStringStream e;
         e << "STRINGS option REGEX value \""
@@ -525,6 +550,10 @@ bool cmFileCommand::HandleStringsCommand(std::vector<std::string> const& args)
     return false;
     }
 
+  // Match with a copy of the compiled pattern.
+  cmsys::RegularExpression regex(have_regex? *compiled :
+                                 cmsys::RegularExpression());
+
   // Parse strings out of the file.
   int output_size = 0;
   std::vector<std::string> strings;
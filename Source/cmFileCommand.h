@@ -41,6 +41,11 @@ public:
     return new cmFileCommand;
     }
 
+  /**
+   * This determines if one instance may run many invocations.
+   */
+  virtual bool IsReusable() { return true; }
+
   /**
    * This is called when the command is first encountered in
    * the CMakeLists.txt file.
@@ -48,6 +53,12 @@ public:
   virtual bool InitialPass(std::vector<std::string> const& args,
                            cmExecutionStatus &status);
 
+  /**
+   * The output variable of the sub-command, if it has one.
+   */
+  virtual std::string
+  GetLuaResultVariable(std::vector<std::string> const& args);
+
   /**
    * This determines if the command is invoked when in script mode.
    */
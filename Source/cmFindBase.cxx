@@ -15,6 +15,13 @@
 
 =========================================================================*/
 #include "cmFindBase.h"
+
+#include "cmLocalGenerator.h"
+#include "cmGlobalGenerator.h"
+#include "cmCacheManager.h"
+#include "cmLuaUtils.h"
+
+#include <cmsys/auto_ptr.hxx>
   
 cmFindBase::cmFindBase()
 {
@@ -22,6 +29,7 @@ cmFindBase::cmFindBase()
                                "FIND_ARGS_XXX", "<VAR> NAMES name");
   this->AlreadyInCache = false;
   this->AlreadyInCacheWithoutMetaInfo = false;
+  this->UseDirectoryCache = false;
   this->GenericDocumentation = 
     "   FIND_XXX(<VAR> name1 [path1 path2 ...])\n"
     "This is the short-hand signature for the command that "
@@ -589,3 +597,151 @@ bool cmFindBase::CheckForVariableInCache()
     }
   return false;
 }
+
+//----------------------------------------------------------------------------
+bool cmFindBase::CandidateExists(std::string const& path)
+{
+  // The listing rules out most candidates.  A hit may still be a
+  // dangling symlink, which FileExists rejects.
+  return (this->CandidateListed(path) &&
+          cmSystemTools::FileExists(path.c_str()));
+}
+
+//----------------------------------------------------------------------------
+bool cmFindBase::CandidateListed(std::string const& path)
+{
+  cmLocalGenerator* lg = this->Makefile->GetLocalGenerator();
+  if(!this->UseDirectoryCache || !lg)
+    {
+    return true;
+    }
+  std::string dir = cmSystemTools::GetFilenamePath(path);
+  std::string name = cmSystemTools::GetFilenameName(path);
+#if defined(_WIN32) || defined(__APPLE__) || defined(__CYGWIN__)
+  name = cmSystemTools::LowerCase(name);
+#endif
+  std::set<cmStdString> const& content =
+    lg->GetGlobalGenerator()->GetFindDirectoryContent(dir);
+  return content.find(name) != content.end();
+}
+
+//----------------------------------------------------------------------------
+// Append the string elements of the array in field "key" of the table
+// at index 1, or the field itself if it is a string.
+static void cmFindBaseLuaField(lua_State* L, const char* key,
+                               const char* keyword,
+                               std::vector<std::string>& args)
+{
+  lua_getfield(L, 1, key);
+  if(lua_isstring(L, -1))
+    {
+    if(keyword)
+      {
+      args.push_back(keyword);
+      }
+    args.push_back(lua_tostring(L, -1));
+    }
+  else if(lua_istable(L, -1))
+    {
+    int n = static_cast<int>(lua_objlen(L, -1));
+    if(keyword && n > 0)
+      {
+      args.push_back(keyword);
+      }
+    for(int i = 1; i <= n; ++i)
+      {
+      lua_rawgeti(L, -1, i);
+      if(lua_isstring(L, -1))
+        {
+        args.push_back(lua_tostring(L, -1));
+        }
+      lua_pop(L, 1);
+      }
+    }
+  lua_pop(L, 1);
+}
+
+//----------------------------------------------------------------------------
+int cmFindBase::LuaFind(lua_State* L)
+{
+  luaL_checktype(L, 1, LUA_TTABLE);
+  lua_getfield(L, 1, "kind");
+  const char* kind = lua_isnil(L, -1)? "library" : lua_tostring(L, -1);
+  lua_pop(L, 1);
+  const char* command = 0;
+  if(!kind)
+    {
+    return luaL_error(L, "cmake.find: kind must be a string");
+    }
+  else if(strcmp(kind, "library") == 0) { command = "find_library"; }
+  else if(strcmp(kind, "path") == 0)    { command = "find_path"; }
+  else if(strcmp(kind, "file") == 0)    { command = "find_file"; }
+  else if(strcmp(kind, "program") == 0) { command = "find_program"; }
+  else
+    {
+    return luaL_error(L, "cmake.find: unknown kind \"%s\"", kind);
+    }
+
+  bool ok = false;
+  {
+  cmMakefile* mf = cmCommand::GetLuaMakefile(L);
+  cmCommand* proto = mf->GetCMakeInstance()->GetCommand(command);
+  cmsys::auto_ptr<cmCommand> cmd(proto? proto->Clone() : 0);
+  cmFindBase* find = cmFindBase::SafeDownCast(cmd.get());
+  if(find)
+    {
+    // Without a result variable use a temporary cache entry.
+    std::vector<std::string> args;
+    cmFindBaseLuaField(L, "var", 0, args);
+    bool temporary = args.empty();
+    if(temporary)
+      {
+      args.push_back("CMAKE_LUA_FIND_RESULT");
+      }
+    cmFindBaseLuaField(L, "names", "NAMES", args);
+    cmFindBaseLuaField(L, "paths", "PATHS", args);
+    cmFindBaseLuaField(L, "path_suffixes", "PATH_SUFFIXES", args);
+    cmFindBaseLuaField(L, "doc", "DOC", args);
+    int n = static_cast<int>(lua_objlen(L, 1));
+    for(int i = 1; i <= n; ++i)
+      {
+      lua_rawgeti(L, 1, i);
+      if(lua_isstring(L, -1))
+        {
+        args.push_back(lua_tostring(L, -1));
+        }
+      lua_pop(L, 1);
+      }
+
+    cmExecutionStatus status;
+    find->SetMakefile(mf);
+    find->SetUseDirectoryCache(true);
+    ok = find->InitialPass(args, status);
+    if(ok)
+      {
+      const char* value = mf->GetDefinition(args[0].c_str());
+      if(value && !cmSystemTools::IsNOTFOUND(value))
+        {
+        lua_pushstring(L, value);
+        }
+      else
+        {
+        lua_pushnil(L);
+        }
+      }
+    else
+      {
+      mf->IssueMessage(cmake::FATAL_ERROR, find->GetError());
+      }
+    if(temporary)
+      {
+      mf->GetCacheManager()->RemoveCacheEntry(args[0].c_str());
+      }
+    }
+  }
+  if(!ok)
+    {
+    return luaL_error(L, "cmake.find failed");
+    }
+  return 1;
+}
@@ -34,11 +34,37 @@ public:
    * the CMakeLists.txt file.
    */
   virtual bool ParseArguments(std::vector<std::string> const& args);
+
+  /**
+   * The VAR of find_*(VAR ...) receives the path found.
+   */
+  virtual std::string
+  GetLuaResultVariable(std::vector<std::string> const& args)
+    {
+    return cmCommand::GetFirstArgument(args);
+    }
   cmTypeMacro(cmFindBase, cmFindCommon);
   
   virtual const char* GetFullDocumentation()
     {return this->GenericDocumentation.c_str();}
 
+  /**
+   * Look candidates up in the directory listings cached by the global
+   * generator instead of asking the file system for each of them.  A
+   * directory is read once per configure step, so files created after
+   * its first probe are not seen until the next one.
+   */
+  void SetUseDirectoryCache(bool b) { this->UseDirectoryCache = b; }
+
+  /**
+   * The cmake.find{...} Lua function.  The table gives the "kind" of
+   * search (library, path, file or program), the "names", "paths" and
+   * "path_suffixes" arrays, an optional cache "var" and extra find
+   * options like "NO_DEFAULT_PATH" in its array part.  It returns the
+   * path found, or nil.  Directory listings are cached for the run.
+   */
+  static int LuaFind(lua_State* L);
+
 protected:
   void PrintFindStuff();
   void ExpandPaths(std::vector<std::string> userPaths);
@@ -58,6 +84,13 @@ protected:
   // also copy the documentation from the cache to VariableDocumentation
   // if it has documentation in the cache
   bool CheckForVariableInCache();
+
+  // check whether a candidate file exists
+  bool CandidateExists(std::string const& path);
+  // check the cached listing of the candidate's directory without
+  // touching the file; true when the directory cache is not used
+  bool CandidateListed(std::string const& path);
+  bool UseDirectoryCache;
   
   cmStdString GenericDocumentation;
   // use by command during find
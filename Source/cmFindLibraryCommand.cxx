@@ -271,7 +271,8 @@ std::string cmFindLibraryCommand::FindLibrary(const char* name)
       tryPath = *p;
       tryPath += name;
       tryPath += ".framework";
-      if(cmSystemTools::FileExists(tryPath.c_str())
+      if(this->CandidateListed(tryPath)
+         && cmSystemTools::FileExists(tryPath.c_str())
          && cmSystemTools::FileIsDirectory(tryPath.c_str()))
         {
         tryPath = cmSystemTools::CollapseFullPath(tryPath.c_str());
@@ -286,7 +287,8 @@ std::string cmFindLibraryCommand::FindLibrary(const char* name)
         {
         tryPath = *p;
         tryPath += name;
-        if(cmSystemTools::FileExists(tryPath.c_str(), true))
+        if(this->CandidateListed(tryPath)
+           && cmSystemTools::FileExists(tryPath.c_str(), true))
           {
           tryPath = cmSystemTools::CollapseFullPath(tryPath.c_str());
           cmSystemTools::ConvertToUnixSlashes(tryPath);
@@ -305,7 +307,8 @@ std::string cmFindLibraryCommand::FindLibrary(const char* name)
           tryPath += *prefix;
           tryPath += name;
           tryPath += *suffix;
-          if(cmSystemTools::FileExists(tryPath.c_str())
+          if(this->CandidateListed(tryPath)
+             && cmSystemTools::FileExists(tryPath.c_str())
              && !cmSystemTools::FileIsDirectory(tryPath.c_str()))
             {
             tryPath = cmSystemTools::CollapseFullPath(tryPath.c_str());
@@ -911,6 +911,33 @@ void cmFindPackageCommand::AppendToProperty(const char* propertyName)
                                                   propertyValue.c_str());
  }
 
+//----------------------------------------------------------------------------
+bool cmFindPackageCommand::GetLuaResult(cmMakefile* mf,
+                                        std::vector<std::string> const& args,
+                                        const char*& value)
+{
+  if(args.empty())
+    {
+    return false;
+    }
+
+  // Find modules often set only the upper-case variable, for example
+  // LIBXML2_FOUND for LibXml2.  Check both like
+  // AppendSuccessInformation does.
+  std::string found = args[0];
+  found += "_FOUND";
+  value = mf->GetDefinition(found.c_str());
+  if(!cmSystemTools::IsOn(value))
+    {
+    std::string upperFound = cmSystemTools::UpperCase(found);
+    if(const char* upperValue = mf->GetDefinition(upperFound.c_str()))
+      {
+      value = upperValue;
+      }
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 void cmFindPackageCommand::AppendSuccessInformation()
 {
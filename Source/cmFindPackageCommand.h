@@ -46,6 +46,13 @@ public:
   virtual bool InitialPass(std::vector<std::string> const& args,
                            cmExecutionStatus &status);
 
+  /**
+   * A Lua call returns whether the package was found.
+   */
+  virtual bool GetLuaResult(cmMakefile* mf,
+                            std::vector<std::string> const& args,
+                            const char*& value);
+
   /**
    * This determines if the command is invoked when in script mode.
    */
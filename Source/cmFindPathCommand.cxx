@@ -134,7 +134,7 @@ bool cmFindPathCommand
         {
         tryPath = this->SearchPaths[k];
         tryPath += this->Names[j];
-        if(cmSystemTools::FileExists(tryPath.c_str()))
+        if(this->CandidateExists(tryPath))
           {
           if(this->IncludeFileInPath)
             {
@@ -196,7 +196,7 @@ std::string cmFindPathCommand::FindHeaderInFramework(std::string& file,
       std::string intPath = fpath;
       intPath += "/Headers/";
       intPath += fileName;
-      if(cmSystemTools::FileExists(intPath.c_str()))
+      if(this->CandidateExists(intPath))
         { 
         if(this->IncludeFileInPath)
           {
@@ -126,14 +126,34 @@ ScopeEnded(cmMakefile &mf)
 bool cmForEachCommand
 ::InitialPass(std::vector<std::string> const& args, cmExecutionStatus &)
 {
-  if(args.size() < 1)
+  std::vector<std::string> loopArgs;
+  std::string error;
+  if(!cmForEachCommand::GetLoopArguments(*this->Makefile, args,
+                                         loopArgs, error))
     {
-    this->SetError("called with incorrect number of arguments");
+    this->SetError(error.c_str());
     return false;
     }
   
   // create a function blocker
   cmForEachFunctionBlocker *f = new cmForEachFunctionBlocker();
+  f->Args = loopArgs;
+  this->Makefile->AddFunctionBlocker(f);
+  
+  return true;
+}
+
+bool cmForEachCommand
+::GetLoopArguments(cmMakefile& mf, std::vector<std::string> const& args,
+                   std::vector<std::string>& loopArgs,
+                   std::string& error)
+{
+  if(args.size() < 1)
+    {
+    error = "called with incorrect number of arguments";
+    return false;
+    }
+  
   if ( args.size() > 1 )
     {
     if ( args[1] == "RANGE" )
@@ -176,7 +196,7 @@ bool cmForEachCommand
         cmOStringStream str;
         str << "called with incorrect range specification: start ";
         str << start << ", stop " << stop << ", step " << step;
-        this->SetError(str.str().c_str());
+        error = str.str();
         return false;
         }
       std::vector<std::string> range;
@@ -196,19 +216,48 @@ bool cmForEachCommand
           break;
           }
         }
-      f->Args = range;
+      loopArgs = range;
+      }
+    else if ( args[1] == "IN" && args.size() > 2 &&
+              (args[2] == "LISTS" || args[2] == "ITEMS") )
+      {
+      // Take the elements of the named lists as the variables keep
+      // them split, then the literal items.
+      loopArgs.clear();
+      loopArgs.push_back(args[0]);
+      bool items = false;
+      std::vector<std::string> buffer;
+      std::vector<std::string>::const_iterator i;
+      for ( i = args.begin() + 2; i != args.end(); ++i )
+        {
+        if ( items )
+          {
+          loopArgs.push_back(*i);
+          }
+        else if ( *i == "ITEMS" )
+          {
+          items = true;
+          }
+        else if ( *i != "LISTS" )
+          {
+          std::vector<std::string> const* list =
+            mf.GetDefinitionList(i->c_str(), buffer);
+          if ( list )
+            {
+            loopArgs.insert(loopArgs.end(), list->begin(), list->end());
+            }
+          }
+        }
       }
     else
       {
-      f->Args = args;
+      loopArgs = args;
       }
     }
   else
     {
-    f->Args = args;
+    loopArgs = args;
     }
-  this->Makefile->AddFunctionBlocker(f);
-  
   return true;
 }
 
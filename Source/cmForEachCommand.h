@@ -60,6 +60,11 @@ public:
     return new cmForEachCommand;
     }
 
+  /**
+   * This determines if one instance may run many invocations.
+   */
+  virtual bool IsReusable() { return true; }
+
   /**
    * This is called when the command is first encountered in
    * the CMakeLists.txt file.
@@ -67,6 +72,16 @@ public:
   virtual bool InitialPass(std::vector<std::string> const& args,
                            cmExecutionStatus &status);
 
+  /**
+   * Compute the loop variable followed by the values it takes from
+   * the expanded foreach arguments, generating a RANGE or reading the
+   * IN LISTS variables if requested.
+   */
+  static bool GetLoopArguments(cmMakefile& mf,
+                               std::vector<std::string> const& args,
+                               std::vector<std::string>& loopArgs,
+                               std::string& error);
+
   /**
    * This determines if the command is invoked when in script mode.
    */
@@ -98,6 +113,7 @@ public:
       "  endforeach(loop_var)\n"
       "  foreach(loop_var RANGE total)\n"
       "  foreach(loop_var RANGE start stop [step])\n"
+      "  foreach(loop_var IN [LISTS [list1 [...]]] [ITEMS [item1 [...]]])\n"
       "All commands between foreach and the matching endforeach are recorded "
       "without being invoked.  Once the endforeach is evaluated, the "
       "recorded list of commands is invoked once for each argument listed "
@@ -111,7 +127,11 @@ public:
       "* When specifying two numbers, the range will have elements from "
       "the first number to the second number.\n"
       "* The third optional number is the increment used to iterate from "
-      "the first number to the second number.";
+      "the first number to the second number.\n"
+      "The IN form iterates over the elements of the lists named after "
+      "LISTS, followed by the items given after ITEMS.  Naming a list "
+      "reads the elements the variable keeps split, so it avoids "
+      "expanding \"${list}\" into arguments again.";
     }
   
   cmTypeMacro(cmForEachCommand, cmCommand);
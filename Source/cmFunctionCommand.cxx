@@ -17,26 +17,41 @@
 #include "cmFunctionCommand.h"
 
 #include "cmake.h"
+#include "cmListFileProgram.h"
+
+// The recorded body of a function.  A function command is cloned for
+// every invocation, so the clones share one body instead of copying it.
+struct cmFunctionBody
+{
+  cmFunctionBody(): ReferenceCount(1) {}
+  int ReferenceCount;
+
+  std::vector<std::string> Args;
+  cmListFile Body;
+};
 
 // define the class for function commands
 class cmFunctionHelperCommand : public cmCommand
 {
 public:
-  cmFunctionHelperCommand() {}
+  cmFunctionHelperCommand(cmFunctionBody* body): Body(body) {}
 
   ///! clean up any memory allocated by the function
-  ~cmFunctionHelperCommand() {};
+  ~cmFunctionHelperCommand()
+  {
+    if(--this->Body->ReferenceCount == 0)
+      {
+      delete this->Body;
+      }
+  }
 
   /**
    * This is a virtual constructor for the command.
    */
   virtual cmCommand* Clone()
   {
-    cmFunctionHelperCommand *newC = new cmFunctionHelperCommand;
-    // we must copy when we clone
-    newC->Args = this->Args;
-    newC->Functions = this->Functions;
-    return newC;
+    ++this->Body->ReferenceCount;
+    return new cmFunctionHelperCommand(this->Body);
   }
 
   /**
@@ -51,13 +66,18 @@ public:
   virtual bool InvokeInitialPass(const std::vector<cmListFileArgument>& args,
                                  cmExecutionStatus &);
 
+  /**
+   * Formal parameters are bound from the listfile arguments.
+   */
+  virtual bool AcceptsDirectArguments() { return false; }
+
   virtual bool InitialPass(std::vector<std::string> const&,
                            cmExecutionStatus &) { return false; };
 
   /**
    * The name of the command as specified in CMakeList.txt.
    */
-  virtual const char* GetName() { return this->Args[0].c_str(); }
+  virtual const char* GetName() { return this->Body->Args[0].c_str(); }
   
   /**
    * Succinct documentation.
@@ -79,8 +99,8 @@ public:
 
   cmTypeMacro(cmFunctionHelperCommand, cmCommand);
 
-  std::vector<std::string> Args;
-  std::vector<cmListFileFunction> Functions;
+private:
+  cmFunctionBody* Body;
 };
 
 
@@ -94,11 +114,11 @@ bool cmFunctionHelperCommand::InvokeInitialPass
 
   // make sure the number of arguments passed is at least the number
   // required by the signature
-  if (expandedArgs.size() < this->Args.size() - 1)
+  if (expandedArgs.size() < this->Body->Args.size() - 1)
     {
     std::string errorMsg =
       "Function invoked with incorrect arguments for function named: ";
-    errorMsg += this->Args[0];
+    errorMsg += this->Body->Args[0];
     this->SetError(errorMsg.c_str());
     return false;
     }
@@ -121,9 +141,9 @@ bool cmFunctionHelperCommand::InvokeInitialPass
     }
   
   // define the formal arguments
-  for (unsigned int j = 1; j < this->Args.size(); ++j)
+  for (unsigned int j = 1; j < this->Body->Args.size(); ++j)
     {
-    this->Makefile->AddDefinition(this->Args[j].c_str(), 
+    this->Makefile->AddDefinition(this->Body->Args[j].c_str(), 
                                   expandedArgs[j-1].c_str());
     }
 
@@ -139,7 +159,7 @@ bool cmFunctionHelperCommand::InvokeInitialPass
       argvDef += ";";
       }
     argvDef += *eit;
-    if ( cnt >= this->Args.size()-1 )
+    if ( cnt >= this->Body->Args.size()-1 )
       {
       if ( argnDef.size() > 0 )
         {
@@ -152,12 +172,34 @@ bool cmFunctionHelperCommand::InvokeInitialPass
   this->Makefile->AddDefinition("ARGV", argvDef.c_str());
   this->Makefile->AddDefinition("ARGN", argnDef.c_str());
 
+  // Run the compiled body if requested and possible.
+  cmListFileProgram const* program = 0;
+  if(this->Makefile->IsOn("CMAKE_COMPILE_LISTFILES"))
+    {
+    program = this->Body->Body.GetProgram();
+    }
+  if(program)
+    {
+    cmExecutionStatus status;
+    if(!program->Execute(*this->Makefile, status, true))
+      {
+      // The error message should have already included the call stack
+      // so we do not need to report an error here.
+      inStatus.SetNestedError(true);
+      return false;
+      }
+    this->Makefile->PopScope();
+    return true;
+    }
+
   // Invoke all the functions that were collected in the block.
   // for each function
-  for(unsigned int c = 0; c < this->Functions.size(); ++c)
+  std::vector<cmListFileFunction> const& functions =
+    this->Body->Body.Functions;
+  for(unsigned int c = 0; c < functions.size(); ++c)
     {
     cmExecutionStatus status;
-    if (!this->Makefile->ExecuteCommand(this->Functions[c],status) ||
+    if (!this->Makefile->ExecuteCommand(functions[c],status) ||
         status.GetNestedError())
       {
       // The error message should have already included the call stack
@@ -202,20 +244,22 @@ IsFunctionBlocked(const cmListFileFunction& lff, cmMakefile &mf,
       name += " )";
 
       // create a new command and add it to cmake
-      cmFunctionHelperCommand *f = new cmFunctionHelperCommand();
-      f->Args = this->Args;
-      f->Functions = this->Functions;
+      cmFunctionBody* body = new cmFunctionBody;
+      body->Args = this->Args;
+      body->Body.Functions = this->Functions;
+      std::vector<cmListFileFunction>& functions = body->Body.Functions;
       
       // Set the FilePath on the arguments to match the function since it is
       // not stored and the original values may be freed
-      for (unsigned int i = 0; i < f->Functions.size(); ++i)
+      for (unsigned int i = 0; i < functions.size(); ++i)
         {
-        for (unsigned int j = 0; j < f->Functions[i].Arguments.size(); ++j)
+        for (unsigned int j = 0; j < functions[i].Arguments.size(); ++j)
           {
-          f->Functions[i].Arguments[j].FilePath = 
-            f->Functions[i].FilePath.c_str();
+          functions[i].Arguments[j].FilePath = 
+            functions[i].FilePath.c_str();
           }
         }
+      cmFunctionHelperCommand *f = new cmFunctionHelperCommand(body);
 
       std::string newName = "_" + this->Args[0];
       mf.GetCMakeInstance()->RenameCommand(this->Args[0].c_str(), 
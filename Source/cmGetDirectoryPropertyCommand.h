@@ -34,6 +34,15 @@ public:
   virtual bool InitialPass(std::vector<std::string> const& args,
                            cmExecutionStatus &status);
 
+  /**
+   * get_directory_property(VAR ...) stores the value in VAR.
+   */
+  virtual std::string
+  GetLuaResultVariable(std::vector<std::string> const& args)
+    {
+    return cmCommand::GetFirstArgument(args);
+    }
+
   /**
    * This determines if the command is invoked when in script mode.
    */
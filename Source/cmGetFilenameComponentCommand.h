@@ -36,6 +36,11 @@ public:
     return new cmGetFilenameComponentCommand;
     }
 
+  /**
+   * This determines if one instance may run many invocations.
+   */
+  virtual bool IsReusable() { return true; }
+
   /**
    * This is called when the command is first encountered in
    * the CMakeLists.txt file.
@@ -43,6 +48,15 @@ public:
   virtual bool InitialPass(std::vector<std::string> const& args,
                            cmExecutionStatus &status);
 
+  /**
+   * get_filename_component(VAR file part) stores the part in VAR.
+   */
+  virtual std::string
+  GetLuaResultVariable(std::vector<std::string> const& args)
+    {
+    return cmCommand::GetFirstArgument(args);
+    }
+
   /**
    * This determines if the command is invoked when in script mode.
    */
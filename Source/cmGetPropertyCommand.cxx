@@ -25,39 +25,59 @@
 
 static int cmGetPropertyLua(lua_State *L) 
 {
+  bool badArguments = false;
+  {
   // build a list file function 
   cmListFileFunction lff;
   cmExecutionStatus status;
   
   lff.Name = lua_tostring(L, lua_upvalueindex(1));
+  cmCommand::GetLuaContext(L, lff);
   
   // stick in a temp var
   lff.Arguments.push_back
     (cmListFileArgument("__GET_PROPERTY_LUA_TEMP", false, 0, 0));
 
-  int i;
-  int top = lua_gettop(L);
-  for (i = 1; i <= top; i++) 
-    { 
-    const char *arg = lua_tostring(L, i);
-    lff.Arguments.push_back(cmListFileArgument(arg, false,
-                                               0, 0));
+  std::vector<std::string> args;
+  std::string error;
+  if(!cmCommand::GetLuaArguments(L, args, error))
+    {
+    // Keep the message on the Lua stack, it must outlive this scope.
+    lua_pushstring(L, error.c_str());
+    badArguments = true;
     }
+  else
+    {
+    for(std::vector<std::string>::const_iterator i = args.begin();
+        i != args.end(); ++i)
+      {
+      lff.Arguments.push_back(cmListFileArgument(*i, true,
+                                                 lff.FilePath.c_str(),
+                                                 lff.Line));
+      }
 
-  // get the current makefile
-  lua_pushstring(L,"cmCurrentMakefile");
-  lua_gettable(L, LUA_REGISTRYINDEX);
-  cmMakefile *mf = static_cast<cmMakefile *>(lua_touserdata(L,-1));
-
-  // pass it to ExecuteCommand
-  mf->ExecuteCommand(lff, status);
-  // What should I do with status?
+    // get the current makefile
+    cmMakefile *mf = cmCommand::GetLuaMakefile(L);
 
-  // get the return value
-  const char *result = mf->GetDefinition("__GET_PROPERTY_LUA_TEMP");
-  lua_pushstring(L, result);
+    // pass it to ExecuteCommand, the error is reported there
+    if(mf->ExecuteCommand(lff, status))
+      {
+      // get the return value
+      const char *result = mf->GetDefinition("__GET_PROPERTY_LUA_TEMP");
+      lua_pushstring(L, result);
+      return 1;  /* number of results */
+      }
+    }
+  }
 
-  return 1;  /* number of results */
+  // Raise the error only after the C++ objects above are gone,
+  // lua_error does not unwind.
+  if(badArguments)
+    {
+    return luaL_error(L, "%s", lua_tostring(L, -1));
+    }
+  return luaL_error(L, "cmake.%s failed",
+                    lua_tostring(L, lua_upvalueindex(1)));
 }
 
 // special lua code
@@ -34,6 +34,15 @@ public:
   virtual bool InitialPass(std::vector<std::string> const& args,
                            cmExecutionStatus &status);
 
+  /**
+   * get_source_file_property(VAR file prop) stores the value in VAR.
+   */
+  virtual std::string
+  GetLuaResultVariable(std::vector<std::string> const& args)
+    {
+    return cmCommand::GetFirstArgument(args);
+    }
+
   /**
    * The name of the command as specified in CMakeList.txt.
    */
@@ -34,6 +34,15 @@ public:
   virtual bool InitialPass(std::vector<std::string> const& args,
                            cmExecutionStatus &status);
 
+  /**
+   * The result variable is the third argument.
+   */
+  virtual std::string
+  GetLuaResultVariable(std::vector<std::string> const& args)
+    {
+    return args.size() < 3? std::string() : args[2];
+    }
+
   /**
    * The name of the command as specified in CMakeList.txt.
    */
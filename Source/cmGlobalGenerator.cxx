@@ -22,6 +22,7 @@
 #include "cmLocalGenerator.h"
 #include "cmExternalMakefileProjectGenerator.h"
 #include "cmake.h"
+#include "cmLuaAllocator.h"
 #include "cmMakefile.h"
 #include "cmSourceFile.h"
 #include "cmVersion.h"
@@ -710,6 +711,35 @@ void cmGlobalGenerator::Configure()
   // now do it
   lg->Configure();
 
+  // Files created by the configure step are not in these listings.
+  this->FindDirectoryContentMap.clear();
+
+  if(this->CMakeInstance->GetDebugOutput())
+    {
+    cmOStringStream msg;
+    msg << "Lua command calls: "
+        << this->CMakeInstance->GetLuaDirectCalls() << " direct, "
+        << this->CMakeInstance->GetLuaListFileCalls()
+        << " through listfile arguments";
+    cmSystemTools::Message(msg.str().c_str());
+    }
+
+  // report the Lua heap of projects with Lua listfiles
+  cmLuaAllocator* luaAllocator = this->CMakeInstance->GetLuaAllocator();
+  if(this->CMakeInstance->GetLuaDirectCalls() > 0 ||
+     this->CMakeInstance->GetLuaListFileCalls() > 0)
+    {
+    char buf[256];
+    sprintf(buf, "Lua heap: peak %lu KB, %lu allocations, %lu KB freed, "
+            "%.3f s in %lu collector sweeps",
+            static_cast<unsigned long>(luaAllocator->GetPeakBytes() / 1024),
+            luaAllocator->GetAllocations(),
+            static_cast<unsigned long>(luaAllocator->GetFreedBytes() / 1024),
+            luaAllocator->GetSweepTime(),
+            luaAllocator->GetSweeps());
+    this->CMakeInstance->UpdateProgress(buf, -1);
+    }
+
   // update the cache entry for the number of local generators, this is used
   // for progress
   char num[100];
@@ -939,7 +969,8 @@ void cmGlobalGenerator::CheckLocalGenerators()
 int cmGlobalGenerator::TryCompile(const char *srcdir, const char *bindir,
                                   const char *projectName,
                                   const char *target,
-                                  std::string *output, cmMakefile *mf)
+                                  std::string *output, cmMakefile *mf,
+                                  const char* buildOptions)
 {
   // if this is not set, then this is a first time configure
   // and there is a good chance that the try compile stuff will
@@ -990,7 +1021,12 @@ int cmGlobalGenerator::TryCompile(const char *srcdir, const char *bindir,
   return this->Build(srcdir,bindir,projectName,
                      newTarget.c_str(),
                      output,makeCommand.c_str(),config,false,true,
-                     this->TryCompileTimeout);
+                     this->TryCompileTimeout, buildOptions);
+}
+
+std::string cmGlobalGenerator::GenerateParallelBuildOptions(unsigned int)
+{
+  return "";
 }
 
 std::string cmGlobalGenerator
@@ -1035,7 +1071,8 @@ int cmGlobalGenerator::Build(
   const char *makeCommandCSTR,
   const char *config,
   bool clean, bool fast,
-  double timeout)
+  double timeout,
+  const char* additionalOptions)
 {
   /**
    * Run an executable command and put the stdout in output.
@@ -1096,7 +1133,7 @@ int cmGlobalGenerator::Build(
   // now build
   std::string makeCommand =
     this->GenerateBuildCommand(makeCommandCSTR, projectName,
-                               0, target, config, false, fast);
+                               additionalOptions, target, config, false, fast);
   if(output)
     {
     *output += "\nRun Build Command:";
@@ -1866,6 +1903,25 @@ void cmGlobalGenerator::AddToManifest(const char* config,
   this->DirectoryContentMap[dir].insert(file);
 }
 
+//----------------------------------------------------------------------------
+static void cmGlobalGeneratorLoadDirectory(std::string const& dir,
+                                           std::set<cmStdString>& files)
+{
+  cmsys::Directory d;
+  if(d.Load(dir.c_str()))
+    {
+    unsigned long n = d.GetNumberOfFiles();
+    for(unsigned long i = 0; i < n; ++i)
+      {
+      const char* f = d.GetFile(i);
+      if(strcmp(f, ".") != 0 && strcmp(f, "..") != 0)
+        {
+        files.insert(f);
+        }
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 std::set<cmStdString> const&
 cmGlobalGenerator::GetDirectoryContent(std::string const& dir, bool needDisk)
@@ -1874,21 +1930,35 @@ cmGlobalGenerator::GetDirectoryContent(std::string const& dir, bool needDisk)
   if(needDisk && !dc.LoadedFromDisk)
     {
     // Load the directory content from disk.
-    cmsys::Directory d;
-    if(d.Load(dir.c_str()))
-      {
-      unsigned long n = d.GetNumberOfFiles();
-      for(unsigned long i = 0; i < n; ++i)
-        {
-        const char* f = d.GetFile(i);
-        if(strcmp(f, ".") != 0 && strcmp(f, "..") != 0)
-          {
-          dc.insert(f);
-          }
-        }
-      }
+    cmGlobalGeneratorLoadDirectory(dir, dc);
     dc.LoadedFromDisk = true;
     }
   return dc;
 }
 
+//----------------------------------------------------------------------------
+std::set<cmStdString> const&
+cmGlobalGenerator::GetFindDirectoryContent(std::string const& dir)
+{
+  std::map<cmStdString, std::set<cmStdString> >::iterator i =
+    this->FindDirectoryContentMap.find(dir);
+  if(i == this->FindDirectoryContentMap.end())
+    {
+    i = this->FindDirectoryContentMap.insert(
+      std::map<cmStdString, std::set<cmStdString> >::value_type(
+        dir, std::set<cmStdString>())).first;
+#if defined(_WIN32) || defined(__APPLE__) || defined(__CYGWIN__)
+    std::set<cmStdString> files;
+    cmGlobalGeneratorLoadDirectory(dir, files);
+    for(std::set<cmStdString>::const_iterator f = files.begin();
+        f != files.end(); ++f)
+      {
+      i->second.insert(cmSystemTools::LowerCase(*f));
+      }
+#else
+    cmGlobalGeneratorLoadDirectory(dir, i->second);
+#endif
+    }
+  return i->second;
+}
+
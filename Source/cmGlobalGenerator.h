@@ -95,27 +95,37 @@ public:
    */
   virtual int TryCompile(const char *srcdir, const char *bindir,
                          const char *projectName, const char *targetName,
-                         std::string *output, cmMakefile* mf);
+                         std::string *output, cmMakefile* mf,
+                         const char* buildOptions = 0);
 
   
   /**
    * Build a file given the following information. This is a more direct call
    * that is used by both CTest and TryCompile. If target name is NULL or
    * empty then all is assumed. clean indicates if a "make clean" should be
-   * done first.
+   * done first.  additionalOptions are passed to the build tool.
    */
   virtual int Build(const char *srcdir, const char *bindir,
                     const char *projectName, const char *targetName,
                     std::string *output, 
                     const char *makeProgram, const char *config,
                     bool clean, bool fast,
-                    double timeout);
+                    double timeout,
+                    const char* additionalOptions = 0);
   virtual std::string GenerateBuildCommand
   (const char* makeProgram,
    const char *projectName, const char* additionalOptions, 
    const char *targetName,
    const char* config, bool ignoreErrors, bool fast);
 
+  /**
+   * Get the build tool options that build independent targets in
+   * parallel, up to the given number of jobs at a time, and keep
+   * going past targets that fail to build.  Returns an empty string
+   * if the build tool of this generator cannot keep going.
+   */
+  virtual std::string GenerateParallelBuildOptions(unsigned int jobs);
+
 
   ///! Set the CMake instance
   void SetCMakeInstance(cmake *cm);
@@ -221,6 +231,14 @@ public:
   std::set<cmStdString> const& GetDirectoryContent(std::string const& dir,
                                                    bool needDisk);
 
+  /** Get the content of a directory on disk during configure.  Each
+      directory is read once and the listings are dropped when the
+      configure step is done.  It is intended for use only by the find
+      commands.  Where file names are case-insensitive the names are
+      stored in lower case.  */
+  std::set<cmStdString> const& GetFindDirectoryContent(
+    std::string const& dir);
+
   void AddTarget(cmTargets::value_type &v);
 
   virtual const char* GetAllTargetName()          { return "ALL_BUILD"; }
@@ -333,6 +351,11 @@ private:
       derived(dc), LoadedFromDisk(dc.LoadedFromDisk) {}
   };
   std::map<cmStdString, DirectoryContent> DirectoryContentMap;
+
+  // Directory content read by the find commands during configure.  It
+  // is kept apart from the map above, which generation must read fresh
+  // to see files created while configuring.
+  std::map<cmStdString, std::set<cmStdString> > FindDirectoryContentMap;
 };
 
 #endif
@@ -563,6 +563,27 @@ std::string cmGlobalUnixMakefileGenerator3
   return makeCommand;
 }
 
+//----------------------------------------------------------------------------
+std::string
+cmGlobalUnixMakefileGenerator3::GenerateParallelBuildOptions(unsigned int jobs)
+{
+  // The make programs of the other makefile generators, such as nmake,
+  // cannot run jobs in parallel.
+  if(strcmp(this->GetName(), "Unix Makefiles") != 0 &&
+     strcmp(this->GetName(), "MSYS Makefiles") != 0 &&
+     strcmp(this->GetName(), "MinGW Makefiles") != 0)
+    {
+    return "";
+    }
+  cmOStringStream options;
+  options << "-k";
+  if(jobs > 1)
+    {
+    options << " -j" << jobs;
+    }
+  return options.str();
+}
+
 //----------------------------------------------------------------------------
 void
 cmGlobalUnixMakefileGenerator3
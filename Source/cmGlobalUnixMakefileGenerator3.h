@@ -113,6 +113,9 @@ public:
    const char *targetName,
    const char* config, bool ignoreErrors, bool fast);
 
+  // build independent targets in parallel with make -k -j
+  virtual std::string GenerateParallelBuildOptions(unsigned int jobs);
+
   // returns some progress informaiton
   int GetTargetTotalNumberOfActions(cmTarget & target,
                                     std::set<cmStdString> &emitted);
@@ -19,6 +19,8 @@
 
 #include <stdlib.h> // required for atof
 #include <list>
+#include "cmRegularExpressionCache.h"
+
 #include <cmsys/RegularExpression.hxx>
 
 bool cmIfFunctionBlocker::
@@ -425,8 +427,9 @@ bool cmIfCommand::IsTrue(const std::vector<std::string> &args,
         def = cmIfCommand::GetVariableOrString(arg->c_str(), makefile);
         const char* rex = (argP2)->c_str();
         cmStringCommand::ClearMatches(makefile);
-        cmsys::RegularExpression regEntry;
-        if ( !regEntry.compile(rex) )
+        cmsys::RegularExpression const* compiled =
+          cmRegularExpressionCache::Get(rex);
+        if ( !compiled )
           {
           cmOStringStream error;
           error << "Regular expression \"" << rex << "\" cannot compile";
@@ -435,6 +438,7 @@ bool cmIfCommand::IsTrue(const std::vector<std::string> &args,
           strcpy(*errorString, error.str().c_str());
           return false;
           }
+        cmsys::RegularExpression regEntry(*compiled);
         if (regEntry.find(def))
           {
           cmStringCommand::StoreMatches(makefile, regEntry);
@@ -78,33 +78,40 @@ bool cmListCommand
 }
 
 //----------------------------------------------------------------------------
-bool cmListCommand::GetListString(std::string& listString, const char* var)
+std::string
+cmListCommand::GetLuaResultVariable(std::vector<std::string> const& args)
 {
-  if ( !var )
+  if(args.size() < 2)
     {
-    return false;
+    return std::string();
     }
-  // get the old value
-  const char* cacheValue
-    = this->Makefile->GetDefinition(var);
-  if(!cacheValue)
+  const std::string &subCommand = args[0];
+  if(subCommand == "LENGTH" || subCommand == "GET" || subCommand == "FIND")
     {
-    return false;
+    return args.size() < 3? std::string() : args[args.size()-1];
     }
-  listString = cacheValue;
-  return true;
+  // the other sub-commands modify the list in place
+  return args[1];
 }
 
 //----------------------------------------------------------------------------
 bool cmListCommand::GetList(std::vector<std::string>& list, const char* var)
 {
-  std::string listString;
-  if ( !this->GetListString(listString, var) )
+  if ( !var )
     {
     return false;
     }
-  // expand the variable
-  cmSystemTools::ExpandListArgument(listString, list);
+  // copy the elements the variable keeps split
+  std::vector<std::string> const* elements =
+    this->Makefile->GetDefinitionList(var, list);
+  if ( !elements )
+    {
+    return false;
+    }
+  if ( elements != &list )
+    {
+    list = *elements;
+    }
   return true;
 }
 
@@ -119,12 +126,11 @@ bool cmListCommand::HandleLengthCommand(std::vector<std::string> const& args)
 
   const std::string& listName = args[1];
   const std::string& variableName = args[args.size() - 1];
-  std::vector<std::string> varArgsExpanded;
-  // do not check the return value here
-  // if the list var is not found varArgsExpanded will have size 0
-  // and we will return 0
-  this->GetList(varArgsExpanded, listName.c_str());
-  size_t length = varArgsExpanded.size();
+  std::vector<std::string> elements;
+  // if the list var is not found we will return 0
+  std::vector<std::string> const* list =
+    this->Makefile->GetDefinitionList(listName.c_str(), elements);
+  size_t length = list? list->size() : 0;
   char buffer[1024];
   sprintf(buffer, "%d", static_cast<int>(length));
 
@@ -144,12 +150,15 @@ bool cmListCommand::HandleGetCommand(std::vector<std::string> const& args)
   const std::string& listName = args[1];
   const std::string& variableName = args[args.size() - 1];
   // expand the variable
-  std::vector<std::string> varArgsExpanded;
-  if ( !this->GetList(varArgsExpanded, listName.c_str()) )
+  std::vector<std::string> buffer;
+  std::vector<std::string> const* list =
+    this->Makefile->GetDefinitionList(listName.c_str(), buffer);
+  if ( !list )
     {
     this->Makefile->AddDefinition(variableName.c_str(), "NOTFOUND");
     return true;
     }
+  std::vector<std::string> const& varArgsExpanded = *list;
 
   std::string value;
   size_t cc;
@@ -197,20 +206,8 @@ bool cmListCommand::HandleAppendCommand(std::vector<std::string> const& args)
     }
 
   const std::string& listName = args[1];
-  // expand the variable
-  std::string listString;
-  this->GetListString(listString, listName.c_str());
-  size_t cc;
-  for ( cc = 2; cc < args.size(); ++ cc )
-    {
-    if ( listString.size() )
-      {
-      listString += ";";
-      }
-    listString += args[cc];
-    }
-
-  this->Makefile->AddDefinition(listName.c_str(), listString.c_str());
+  std::vector<std::string> elements(args.begin() + 2, args.end());
+  this->Makefile->AppendDefinition(listName.c_str(), elements);
   return true;
 }
 
@@ -226,14 +223,17 @@ bool cmListCommand::HandleFindCommand(std::vector<std::string> const& args)
   const std::string& listName = args[1];
   const std::string& variableName = args[args.size() - 1];
   // expand the variable
-  std::vector<std::string> varArgsExpanded;
-  if ( !this->GetList(varArgsExpanded, listName.c_str()) )
+  std::vector<std::string> buffer;
+  std::vector<std::string> const* list =
+    this->Makefile->GetDefinitionList(listName.c_str(), buffer);
+  if ( !list )
     {
     this->Makefile->AddDefinition(variableName.c_str(), "-1");
     return true;
     }
+  std::vector<std::string> const& varArgsExpanded = *list;
 
-  std::vector<std::string>::iterator it;
+  std::vector<std::string>::const_iterator it;
   unsigned int index = 0;
   for ( it = varArgsExpanded.begin(); it != varArgsExpanded.end(); ++ it )
     {
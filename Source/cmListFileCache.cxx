@@ -20,6 +20,8 @@
 #include "cmSystemTools.h"
 #include "cmMakefile.h"
 #include "cmVersion.h"
+#include "cmGeneratedFileStream.h"
+#include "cmListFileProgram.h"
 
 #include <cmsys/RegularExpression.hxx>
 
@@ -31,6 +33,37 @@ bool cmListFileCacheParseFunction(cmListFileLexer* lexer,
                                   cmListFileFunction& function,
                                   const char* filename);
 
+cmListFile::cmListFile(cmListFile const& r):
+  ModifiedTime(r.ModifiedTime), Length(r.Length), Functions(r.Functions),
+  Program(0)
+{
+}
+
+cmListFile& cmListFile::operator=(cmListFile const& r)
+{
+  this->ModifiedTime = r.ModifiedTime;
+  this->Length = r.Length;
+  this->Functions = r.Functions;
+  delete this->Program;
+  this->Program = 0;
+  return *this;
+}
+
+cmListFile::~cmListFile()
+{
+  delete this->Program;
+}
+
+cmListFileProgram const* cmListFile::GetProgram() const
+{
+  if(!this->Program)
+    {
+    this->Program = new cmListFileProgram;
+    this->Program->Compile(this->Functions);
+    }
+  return this->Program->IsValid()? this->Program : 0;
+}
+
 bool cmListFile::ParseFile(const char* filename, 
                            bool topLevel,
                            cmMakefile *mf)
@@ -60,6 +93,7 @@ bool cmListFile::ParseFile(const char* filename,
   // Use a simple recursive-descent parser to process the token
   // stream.
   this->ModifiedTime = cmSystemTools::ModifiedTime(filename);
+  this->Length = cmSystemTools::FileLength(filename);
   bool parseError = false;
   bool haveNewline = true;
   cmListFileLexer_Token* token;
@@ -288,6 +322,306 @@ bool cmListFileCacheParseFunction(cmListFileLexer* lexer,
 }
 
 //----------------------------------------------------------------------------
+cmListFileCache::cmListFileCache()
+{
+  this->StartTime = static_cast<long int>(time(0));
+}
+
+cmListFileCache::~cmListFileCache()
+{
+  for(FileMap::iterator i = this->Files.begin(); i != this->Files.end(); ++i)
+    {
+    delete i->second;
+    }
+  for(std::vector<cmListFile*>::iterator i = this->Retired.begin();
+      i != this->Retired.end(); ++i)
+    {
+    delete *i;
+    }
+}
+
+cmListFile const* cmListFileCache::GetListFile(const char* path,
+                                               cmMakefile* mf,
+                                               cmListFile& local)
+{
+  long int mtime = cmSystemTools::ModifiedTime(path);
+  unsigned long length = cmSystemTools::FileLength(path);
+
+  // A file modified after we started could be modified again within
+  // the same second, which its time stamp would not show.
+  if(this->IsRecentlyModified(mtime))
+    {
+    return local.ParseFile(path, false, mf)? &local : 0;
+    }
+
+  FileMap::iterator i = this->Files.find(path);
+  if(i != this->Files.end())
+    {
+    if(i->second->ModifiedTime == mtime && i->second->Length == length)
+      {
+      return i->second;
+      }
+    this->Retired.push_back(i->second);
+    this->Files.erase(i);
+    }
+
+  // Parse with the map key as file name so that the arguments' file
+  // path pointers stay valid.
+  i = this->Files.insert(FileMap::value_type(path, 0)).first;
+  cmListFile* lf = new cmListFile;
+  if(!lf->ParseFile(i->first.c_str(), false, mf))
+    {
+    delete lf;
+    this->Files.erase(i);
+    return 0;
+    }
+  i->second = lf;
+  return lf;
+}
+
+// The saved cache holds, for each file, a header line
+//   F <path> <mtime> <length> <functions>
+// then for each function
+//   <name> <line> <arguments>
+// and for each argument
+//   <quoted> <line> <value>
+// where every string is written as <size>:<characters>.
+static void cmListFileCacheWriteString(std::ostream& os,
+                                       std::string const& s)
+{
+  os << s.size() << ":";
+  os.write(s.data(), static_cast<std::streamsize>(s.size()));
+}
+
+static bool cmListFileCacheReadLong(const char*& pos, const char* end,
+                                    long& value)
+{
+  char* next;
+  value = strtol(pos, &next, 10);
+  if(next == pos || next >= end)
+    {
+    return false;
+    }
+  pos = next;
+  while(pos < end && (*pos == ' ' || *pos == '\n'))
+    {
+    ++pos;
+    }
+  return true;
+}
+
+static bool cmListFileCacheReadString(const char*& pos, const char* end,
+                                      std::string& s)
+{
+  char* next;
+  unsigned long size = strtoul(pos, &next, 10);
+  if(next == pos || *next != ':' ||
+     size > static_cast<unsigned long>(end - next - 1))
+    {
+    return false;
+    }
+  s.assign(next+1, size);
+  pos = next + 1 + size;
+  while(pos < end && (*pos == ' ' || *pos == '\n'))
+    {
+    ++pos;
+    }
+  return true;
+}
+
+bool cmListFileCache::Save(const char* fname) const
+{
+  cmGeneratedFileStream fout(fname);
+  if(!fout)
+    {
+    return false;
+    }
+  fout << "# CMake parsed listfile cache, version 1\n";
+  for(FileMap::const_iterator i = this->Files.begin();
+      i != this->Files.end(); ++i)
+    {
+    cmListFile const& lf = *i->second;
+    fout << "F ";
+    cmListFileCacheWriteString(fout, i->first);
+    fout << " " << lf.ModifiedTime << " " << lf.Length << " "
+         << lf.Functions.size() << "\n";
+    for(std::vector<cmListFileFunction>::const_iterator
+          fi = lf.Functions.begin(); fi != lf.Functions.end(); ++fi)
+      {
+      cmListFileCacheWriteString(fout, fi->Name);
+      fout << " " << fi->Line << " " << fi->Arguments.size() << "\n";
+      for(std::vector<cmListFileArgument>::const_iterator
+            ai = fi->Arguments.begin(); ai != fi->Arguments.end(); ++ai)
+        {
+        fout << (ai->Quoted? 1:0) << " " << ai->Line << " ";
+        cmListFileCacheWriteString(fout, ai->Value);
+        fout << "\n";
+        }
+      }
+    }
+  return fout? true : false;
+}
+
+bool cmListFileCache::Load(const char* fname)
+{
+  std::ifstream fin(fname, std::ios::in | std::ios::binary);
+  if(!fin)
+    {
+    return false;
+    }
+  std::string header;
+  if(!cmSystemTools::GetLineFromStream(fin, header) ||
+     header != "# CMake parsed listfile cache, version 1")
+    {
+    return false;
+    }
+  cmOStringStream contents;
+  contents << fin.rdbuf();
+  std::string buffer = contents.str();
+  const char* pos = buffer.c_str();
+  const char* end = pos + buffer.size();
+
+  // Stop at the first damaged record and keep what came before.
+  std::string path;
+  while(pos < end)
+    {
+    long mtime;
+    long length;
+    long nfunctions;
+    if(*pos++ != 'F' || *pos++ != ' ' ||
+       !cmListFileCacheReadString(pos, end, path) ||
+       !cmListFileCacheReadLong(pos, end, mtime) ||
+       !cmListFileCacheReadLong(pos, end, length) ||
+       !cmListFileCacheReadLong(pos, end, nfunctions) || nfunctions < 0)
+      {
+      return false;
+      }
+    FileMap::iterator i = this->Files.find(path);
+    if(i != this->Files.end())
+      {
+      this->Retired.push_back(i->second);
+      this->Files.erase(i);
+      }
+    i = this->Files.insert(FileMap::value_type(path, 0)).first;
+    cmListFile* lf = new cmListFile;
+    i->second = lf;
+    lf->ModifiedTime = mtime;
+    lf->Length = static_cast<unsigned long>(length);
+    lf->Functions.resize(nfunctions);
+    const char* filename = i->first.c_str();
+    for(long f = 0; f < nfunctions; ++f)
+      {
+      cmListFileFunction& lff = lf->Functions[f];
+      long nargs;
+      if(!cmListFileCacheReadString(pos, end, lff.Name) ||
+         !cmListFileCacheReadLong(pos, end, lff.Line) ||
+         !cmListFileCacheReadLong(pos, end, nargs) || nargs < 0)
+        {
+        lf->ModifiedTime = 0;
+        return false;
+        }
+      lff.FilePath = filename;
+      lff.Arguments.resize(nargs);
+      for(long a = 0; a < nargs; ++a)
+        {
+        cmListFileArgument& arg = lff.Arguments[a];
+        long quoted;
+        if(!cmListFileCacheReadLong(pos, end, quoted) ||
+           !cmListFileCacheReadLong(pos, end, arg.Line) ||
+           !cmListFileCacheReadString(pos, end, arg.Value))
+          {
+          lf->ModifiedTime = 0;
+          return false;
+          }
+        arg.Quoted = quoted? true : false;
+        arg.FilePath = filename;
+        }
+      }
+    }
+  return true;
+}
+
+static bool cmListFileIsNameChar(char c)
+{
+  // Same characters as a variable name in cmCommandArgumentLexer.
+  return ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+          (c >= '0' && c <= '9') ||
+          c == '/' || c == '_' || c == '.' || c == '+' || c == '-');
+}
+
+bool cmListFileArgument::CompileTemplate() const
+{
+  if(this->Status != NotCompiled)
+    {
+    return this->Status == Compiled;
+    }
+  this->Status = NotCompilable;
+
+  std::vector<Segment> segments;
+  std::string literal;
+  const char* c = this->Value.c_str();
+  while(*c)
+    {
+    if(*c == '\\' || *c == '@' || *c == '{' || *c == '}')
+      {
+      return false;
+      }
+    if(*c != '$')
+      {
+      literal += *c++;
+      continue;
+      }
+
+    // Accept only ${NAME} and $ENV{NAME}.
+    const char* key = ++c;
+    while(cmListFileIsNameChar(*c))
+      {
+      ++c;
+      }
+    Segment::Type type;
+    if(c == key)
+      {
+      type = Segment::Variable;
+      }
+    else if(std::string(key, c-key) == "ENV")
+      {
+      type = Segment::Environment;
+      }
+    else
+      {
+      return false;
+      }
+    if(*c++ != '{')
+      {
+      return false;
+      }
+    const char* name = c;
+    while(cmListFileIsNameChar(*c))
+      {
+      ++c;
+      }
+    if(c == name || *c != '}')
+      {
+      return false;
+      }
+    if(!literal.empty())
+      {
+      segments.push_back(Segment(Segment::Literal, literal));
+      literal = "";
+      }
+    segments.push_back(Segment(type, std::string(name, c-name)));
+    ++c;
+    }
+  if(!literal.empty())
+    {
+    segments.push_back(Segment(Segment::Literal, literal));
+    }
+
+  this->Template.swap(segments);
+  this->Status = Compiled;
+  return true;
+}
+
 std::ostream& operator<<(std::ostream& os, cmListFileContext const& lfc)
 {
   os << lfc.FilePath;
@@ -19,23 +19,22 @@
 
 #include "cmStandardIncludes.h"
 
-/** \class cmListFileCache
- * \brief A class to cache list file contents.
- *
- * cmListFileCache is a class used to cache the contents of parsed
- * cmake list files.
- */
-
+class cmCommand;
 class cmMakefile;
+class cmListFileProgram;
+class cmake;
  
 struct cmListFileArgument
 {
-  cmListFileArgument(): Value(), Quoted(false), FilePath(0), Line(0) {}
+  cmListFileArgument(): Value(), Quoted(false), FilePath(0), Line(0),
+                        Status(NotCompiled) {}
   cmListFileArgument(const cmListFileArgument& r):
-    Value(r.Value), Quoted(r.Quoted), FilePath(r.FilePath), Line(r.Line) {}
+    Value(r.Value), Quoted(r.Quoted), FilePath(r.FilePath), Line(r.Line),
+    Status(r.Status), Template(r.Template) {}
   cmListFileArgument(const std::string& v, bool q, const char* file,
                      long line): Value(v), Quoted(q),
-                                 FilePath(file), Line(line) {}
+                                 FilePath(file), Line(line),
+                                 Status(NotCompiled) {}
   bool operator == (const cmListFileArgument& r) const
     {
     return (this->Value == r.Value) && (this->Quoted == r.Quoted);
@@ -48,6 +47,39 @@ struct cmListFileArgument
   bool Quoted;
   const char* FilePath;
   long Line;
+
+  /** One piece of a pre-parsed argument: literal text, a ${VAR}
+      reference or an $ENV{VAR} reference.  */
+  struct Segment
+  {
+    enum Type { Literal, Variable, Environment };
+    Segment(Type t, const std::string& text): SegmentType(t), Text(text) {}
+    Type SegmentType;
+    std::string Text;
+  };
+
+  /**
+   * Split Value into segments the first time it is called and return
+   * true if that worked.  Values using escapes, @VAR@, nested
+   * references or anything else the full argument parser must see
+   * are not compiled.  The result is kept with the argument, so Value
+   * must not change after this has been called.
+   */
+  bool CompileTemplate() const;
+
+  /**
+   * Make Value final text that is never expanded, as for arguments
+   * that come from Lua already evaluated.
+   */
+  void SetLiteral()
+    {
+    this->Template.assign(1, Segment(Segment::Literal, this->Value));
+    this->Status = Compiled;
+    }
+
+  enum TemplateStatus { NotCompiled, Compiled, NotCompilable };
+  mutable TemplateStatus Status;
+  mutable std::vector<Segment> Template;
 };
 
 struct cmListFileContext
@@ -61,7 +93,27 @@ std::ostream& operator<<(std::ostream&, cmListFileContext const&);
 
 struct cmListFileFunction: public cmListFileContext
 {
+  cmListFileFunction(): CommandOwner(0), CommandGeneration(0), Command(0) {}
+  cmListFileFunction(const cmListFileFunction& r):
+    cmListFileContext(r), Arguments(r.Arguments),
+    CommandOwner(0), CommandGeneration(0), Command(0) {}
+  cmListFileFunction& operator=(const cmListFileFunction& r)
+    {
+    cmListFileContext::operator=(r);
+    this->Arguments = r.Arguments;
+    this->CommandOwner = 0;
+    this->CommandGeneration = 0;
+    this->Command = 0;
+    return *this;
+    }
   std::vector<cmListFileArgument> Arguments;
+
+  // The command Name resolved to, kept by cmake::ResolveCommand while
+  // the command table of CommandOwner stays at CommandGeneration.
+  // Copies resolve the name again.
+  mutable cmake* CommandOwner;
+  mutable unsigned long CommandGeneration;
+  mutable cmCommand* Command;
 };
 
 class cmListFileBacktrace: public std::vector<cmListFileContext> {};
@@ -69,15 +121,81 @@ class cmListFileBacktrace: public std::vector<cmListFileContext> {};
 struct cmListFile
 {
   cmListFile() 
-    :ModifiedTime(0) 
+    :ModifiedTime(0), Length(0), Program(0)
     {
     }
+  cmListFile(cmListFile const& r);
+  cmListFile& operator=(cmListFile const& r);
+  ~cmListFile();
   bool ParseFile(const char* path, 
                  bool topLevel,
                  cmMakefile *mf);
 
+  /**
+   * Get the compiled form of Functions, compiling it on first use.
+   * Returns 0 if the commands cannot be compiled and must run one by
+   * one.  Functions must not change after this has been called.
+   */
+  cmListFileProgram const* GetProgram() const;
+
   long int ModifiedTime;
+  unsigned long Length;
   std::vector<cmListFileFunction> Functions;
+
+private:
+  mutable cmListFileProgram* Program;
+};
+
+/** \class cmListFileCache
+ * \brief A class to cache list file contents.
+ *
+ * cmListFileCache is a class used to cache the contents of parsed
+ * cmake list files.  Modules are included many times during one
+ * configure, so the cmake instance keeps one for the whole run.
+ */
+class cmListFileCache
+{
+public:
+  cmListFileCache();
+  ~cmListFileCache();
+
+  /**
+   * Get the parsed contents of a listfile that is not the top-level
+   * CMakeLists.txt.  A file that has not changed since it was last
+   * parsed is not read again.  A file modified since this cache was
+   * created may still change during the run, so it is parsed into
+   * 'local' and not cached.  Returns 0 on a parse error.  A returned
+   * cached file stays valid as long as the cache exists.
+   */
+  cmListFile const* GetListFile(const char* path, cmMakefile* mf,
+                                cmListFile& local);
+
+  /**
+   * Load and save the parsed files so that a later run need not lex
+   * the listfiles that did not change.  Entries are checked against
+   * the files on disk when used, so a stale file does no harm.
+   */
+  bool Load(const char* fname);
+  bool Save(const char* fname) const;
+
+  /**
+   * Whether a file with time stamp 'mtime' may have been modified since
+   * this cache was created.  It could then change again within the same
+   * second without a new time stamp, so anything derived from it must
+   * not be cached by time stamp.
+   */
+  bool IsRecentlyModified(long int mtime) const
+    { return mtime == 0 || mtime >= this->StartTime; }
+
+private:
+  typedef std::map<cmStdString, cmListFile*> FileMap;
+  FileMap Files;
+
+  // Replaced entries may still be executing, so free them only at the
+  // end.
+  std::vector<cmListFile*> Retired;
+
+  long int StartTime;
 };
 
 #endif
@@ -0,0 +1,594 @@
+/*=========================================================================
+
+  Program:   CMake - Cross-Platform Makefile Generator
+  Module:    $RCSfile: cmListFileProgram.cxx,v $
+  Language:  C++
+  Date:      $Date: 2008/06/05 16:40:12 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) 2002 Kitware, Inc., Insight Consortium.  All rights reserved.
+  See Copyright.txt or http://www.cmake.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "cmListFileProgram.h"
+
+#include "cmExecutionStatus.h"
+#include "cmForEachCommand.h"
+#include "cmIfCommand.h"
+#include "cmMakefile.h"
+#include "cmProfiler.h"
+#include "cmSystemTools.h"
+#include "cmake.h"
+
+//----------------------------------------------------------------------------
+// A block being compiled.
+struct cmListFileProgram::Block
+{
+  OpCode Kind;
+  cmListFileFunction const* Open;
+
+  // The instruction that opened the block.
+  unsigned int First;
+
+  // The If or ElseIf whose false branch is not yet known, or the
+  // While or ForEach that opened the loop.
+  unsigned int Test;
+  bool HasElse;
+
+  // Jumps to the end of the block.
+  std::vector<unsigned int> Exits;
+
+  // Commands whose break() leaves this block.
+  std::vector<unsigned int> Breaks;
+};
+
+//----------------------------------------------------------------------------
+// State of an active foreach loop.
+struct cmListFileProgramLoop
+{
+  std::vector<std::string> Args;
+  std::vector<std::string>::size_type Next;
+  std::string OldDef;
+};
+
+//----------------------------------------------------------------------------
+// Time a control flow command in --profile while its condition or loop
+// arguments are evaluated, the part of it that still runs.
+class cmListFileProgramTimer
+{
+public:
+  cmListFileProgramTimer(cmMakefile& mf, cmListFileFunction const& lff):
+    Profiler(mf.GetCMakeInstance()->GetProfiler())
+    {
+    if(this->Profiler)
+      {
+      this->Profiler->Start("command", lff.Name.c_str(),
+                            lff.FilePath.c_str(), lff.Line);
+      }
+    }
+  ~cmListFileProgramTimer()
+    {
+    if(this->Profiler)
+      {
+      this->Profiler->Stop();
+      }
+    }
+private:
+  cmProfiler* Profiler;
+};
+
+//----------------------------------------------------------------------------
+static bool cmListFileProgramIs(cmListFileFunction const& lff,
+                                const char* name)
+{
+  return cmSystemTools::Strucmp(lff.Name.c_str(), name) == 0;
+}
+
+//----------------------------------------------------------------------------
+static void cmListFileProgramRestore(cmMakefile& mf,
+                                     std::vector<cmListFileProgramLoop>& loops,
+                                     std::vector<unsigned int>& active)
+{
+  // Restore the loop variables as the interpreter does when it leaves
+  // the loops, innermost first.
+  while(!active.empty())
+    {
+    cmListFileProgramLoop& loop = loops[active.back()];
+    mf.AddDefinition(loop.Args[0].c_str(), loop.OldDef.c_str());
+    active.pop_back();
+    }
+}
+
+//----------------------------------------------------------------------------
+cmListFileProgram::cmListFileProgram(): Slots(0), Valid(false)
+{
+}
+
+//----------------------------------------------------------------------------
+unsigned int cmListFileProgram::Emit(OpCode op,
+                                     cmListFileFunction const* function,
+                                     bool topLevel)
+{
+  Instruction inst;
+  inst.Op = op;
+  inst.Function = function;
+  inst.Target = static_cast<unsigned int>(this->Instructions.size()+1);
+  inst.Slot = 0;
+  inst.TopLevel = topLevel;
+  inst.Close = 0;
+  inst.End = 0;
+  inst.Exit = 0;
+  inst.Open = 0;
+  this->Instructions.push_back(inst);
+  return static_cast<unsigned int>(this->Instructions.size()-1);
+}
+
+//----------------------------------------------------------------------------
+bool cmListFileProgram::CompileFailed()
+{
+  this->Instructions.clear();
+  this->Slots = 0;
+  this->Valid = false;
+  return false;
+}
+
+//----------------------------------------------------------------------------
+void cmListFileProgram::AddBreak(std::vector<Block>& stack,
+                                 unsigned int index)
+{
+  // A break() leaves the innermost loop.  Outside of loops the if
+  // blockers pass it up to the outermost if, and it is ignored
+  // outside of any block.
+  for(std::vector<Block>::reverse_iterator b = stack.rbegin();
+      b != stack.rend(); ++b)
+    {
+    if(b->Kind != If || &*b == &stack.front())
+      {
+      b->Breaks.push_back(index);
+      break;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmListFileProgram::SetBreakTarget(unsigned int index,
+                                       unsigned int target)
+{
+  Instruction& inst = this->Instructions[index];
+  if(inst.Op == If || inst.Op == ForEach)
+    {
+    inst.Exit = target;
+    }
+  else
+    {
+    inst.Target = target;
+    }
+}
+
+//----------------------------------------------------------------------------
+bool cmListFileProgram::Compile(std::vector<cmListFileFunction> const& fns)
+{
+  this->Instructions.clear();
+  this->Slots = 0;
+  this->Valid = false;
+
+  std::vector<Block> stack;
+  for(std::vector<cmListFileFunction>::size_type i = 0; i < fns.size(); ++i)
+    {
+    cmListFileFunction const& lff = fns[i];
+    bool topLevel = stack.empty();
+    Block* top = topLevel? 0 : &stack.back();
+
+    if(cmListFileProgramIs(lff, "function") ||
+       cmListFileProgramIs(lff, "macro"))
+      {
+      // The definition is recorded by its blocker, which counts only
+      // its own kind of nesting.  The body must also be balanced so no
+      // other blocker sees it differently.
+      const char* open = lff.Name.c_str();
+      const char* close = cmListFileProgramIs(lff, "function")?
+        "endfunction" : "endmacro";
+      int depth = 0;
+      int ifs = 0;
+      int whiles = 0;
+      int foreachs = 0;
+      std::vector<cmListFileFunction>::size_type j = i;
+      for(; j < fns.size(); ++j)
+        {
+        cmListFileFunction const& f = fns[j];
+        if(cmListFileProgramIs(f, open))
+          {
+          ++depth;
+          }
+        else if(cmListFileProgramIs(f, close))
+          {
+          if(--depth == 0)
+            {
+            break;
+            }
+          }
+        else if(cmListFileProgramIs(f, "if")) { ++ifs; }
+        else if(cmListFileProgramIs(f, "endif")) { --ifs; }
+        else if(cmListFileProgramIs(f, "while")) { ++whiles; }
+        else if(cmListFileProgramIs(f, "endwhile")) { --whiles; }
+        else if(cmListFileProgramIs(f, "foreach")) { ++foreachs; }
+        else if(cmListFileProgramIs(f, "endforeach")) { --foreachs; }
+        if(ifs < 0 || whiles < 0 || foreachs < 0)
+          {
+          return this->CompileFailed();
+          }
+        }
+      if(j == fns.size() || ifs || whiles || foreachs)
+        {
+        return this->CompileFailed();
+        }
+      // Emit the whole definition as plain commands.
+      for(; i <= j; ++i)
+        {
+        this->Emit(Command, &fns[i], topLevel);
+        }
+      --i;
+      continue;
+      }
+
+    if(cmListFileProgramIs(lff, "if"))
+      {
+      Block b;
+      b.Kind = If;
+      b.Open = &lff;
+      b.HasElse = false;
+      b.Test = this->Emit(If, &lff, topLevel);
+      b.First = b.Test;
+      this->AddBreak(stack, b.First);
+      stack.push_back(b);
+      }
+    else if(!topLevel && (cmListFileProgramIs(lff, "elseif") ||
+                          cmListFileProgramIs(lff, "else")))
+      {
+      if(top->Kind != If || top->HasElse)
+        {
+        return this->CompileFailed();
+        }
+      // The branch before this one is done.
+      top->Exits.push_back(this->Emit(Jump, &lff, false));
+      unsigned int next = static_cast<unsigned int>(this->Instructions.size());
+      this->Instructions[top->Test].Target = next;
+      if(cmListFileProgramIs(lff, "elseif"))
+        {
+        top->Test = this->Emit(ElseIf, &lff, false);
+        this->Instructions[top->Test].Open = top->First;
+        }
+      else
+        {
+        top->HasElse = true;
+        }
+      }
+    else if(!topLevel && cmListFileProgramIs(lff, "endif"))
+      {
+      if(top->Kind != If ||
+         (!lff.Arguments.empty() && lff.Arguments != top->Open->Arguments))
+        {
+        return this->CompileFailed();
+        }
+      unsigned int end = static_cast<unsigned int>(this->Instructions.size());
+      if(!top->HasElse)
+        {
+        this->Instructions[top->Test].Target = end;
+        }
+      top->Breaks.insert(top->Breaks.end(),
+                         top->Exits.begin(), top->Exits.end());
+      for(std::vector<unsigned int>::const_iterator e = top->Breaks.begin();
+          e != top->Breaks.end(); ++e)
+        {
+        this->SetBreakTarget(*e, end);
+        }
+      this->Instructions[top->First].Close = &lff;
+      this->Instructions[top->First].End = end;
+      stack.pop_back();
+      }
+    else if(cmListFileProgramIs(lff, "while"))
+      {
+      if(lff.Arguments.empty())
+        {
+        // Let the command report the error.
+        return this->CompileFailed();
+        }
+      Block b;
+      b.Kind = While;
+      b.Open = &lff;
+      b.HasElse = false;
+      b.Test = this->Emit(While, &lff, topLevel);
+      b.First = b.Test;
+      stack.push_back(b);
+      }
+    else if(!topLevel && cmListFileProgramIs(lff, "endwhile"))
+      {
+      if(top->Kind != While ||
+         (!lff.Arguments.empty() && lff.Arguments != top->Open->Arguments))
+        {
+        return this->CompileFailed();
+        }
+      this->Instructions[this->Emit(Jump, &lff, false)].Target = top->Test;
+      unsigned int end = static_cast<unsigned int>(this->Instructions.size());
+      this->Instructions[top->Test].Target = end;
+      for(std::vector<unsigned int>::const_iterator e = top->Breaks.begin();
+          e != top->Breaks.end(); ++e)
+        {
+        this->SetBreakTarget(*e, end);
+        }
+      stack.pop_back();
+      }
+    else if(cmListFileProgramIs(lff, "foreach"))
+      {
+      Block b;
+      b.Kind = ForEach;
+      b.Open = &lff;
+      b.HasElse = false;
+      b.Test = this->Emit(ForEach, &lff, topLevel);
+      b.First = b.Test;
+      this->Instructions[b.Test].Slot = this->Slots++;
+      this->AddBreak(stack, b.First);
+      stack.push_back(b);
+      }
+    else if(!topLevel && cmListFileProgramIs(lff, "endforeach"))
+      {
+      // The blocker compares the expanded loop variable names.  The
+      // same text expands the same way, so only accept that.
+      if(top->Kind != ForEach ||
+         (!lff.Arguments.empty() &&
+          (top->Open->Arguments.empty() ||
+           lff.Arguments[0] != top->Open->Arguments[0])))
+        {
+        return this->CompileFailed();
+        }
+      unsigned int slot = this->Instructions[top->Test].Slot;
+      unsigned int next = this->Emit(ForEachNext, &lff, false);
+      this->Instructions[next].Target = top->Test + 1;
+      this->Instructions[next].Slot = slot;
+      unsigned int end = this->Emit(ForEachEnd, &lff, false);
+      this->Instructions[end].Slot = slot;
+      this->Instructions[top->Test].Target = end;
+      for(std::vector<unsigned int>::const_iterator e = top->Breaks.begin();
+          e != top->Breaks.end(); ++e)
+        {
+        this->SetBreakTarget(*e, end);
+        }
+      this->Instructions[top->Test].Close = &lff;
+      this->Instructions[top->Test].End = end + 1;
+      stack.pop_back();
+      }
+    else
+      {
+      this->AddBreak(stack, this->Emit(Command, &lff, topLevel));
+      }
+    }
+
+  // An unterminated block is reported by its blocker.
+  if(!stack.empty())
+    {
+    return this->CompileFailed();
+    }
+  this->Valid = true;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool cmListFileProgram::EvaluateCondition(cmMakefile& mf,
+                                          Instruction const& inst,
+                                          bool& isTrue,
+                                          std::string& error) const
+{
+  cmListFileProgramTimer timer(mf, *inst.Function);
+  std::vector<std::string> expandedArguments;
+  mf.ExpandArguments(inst.Function->Arguments, expandedArguments);
+  char* errorString = 0;
+  isTrue = cmIfCommand::IsTrue(expandedArguments, &errorString, &mf);
+  if(errorString)
+    {
+    error = errorString;
+    delete [] errorString;
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool cmListFileProgram::Replay(cmMakefile& mf, Instruction const& inst,
+                               bool stopOnError, cmExecutionStatus& status,
+                               unsigned int& pc, bool& result) const
+{
+  // The opening command reports its error and adds no blocker, so the
+  // interpreter runs the whole block one command at a time, at the
+  // level of the opening command.  The commands that continue or close
+  // the block then report errors of their own.  An if() whose
+  // condition evaluates adds its blocker, which runs the block.
+  // Returns false with the result of Execute if it must stop, or the
+  // next instruction in pc.
+  for(cmListFileFunction const* f = inst.Function;
+      !cmSystemTools::GetFatalErrorOccured(); ++f)
+    {
+    cmExecutionStatus st;
+    if((!mf.ExecuteCommand(*f, st) || st.GetNestedError()) &&
+       stopOnError && inst.TopLevel)
+      {
+      result = false;
+      return false;
+      }
+    if(st.GetReturnInvoked())
+      {
+      status.SetReturnInvoked(true);
+      result = true;
+      return false;
+      }
+    if(st.GetBreakInvoked() && inst.Exit)
+      {
+      pc = inst.Exit;
+      return true;
+      }
+    if(f == inst.Close)
+      {
+      break;
+      }
+    }
+  pc = inst.End;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool cmListFileProgram::Execute(cmMakefile& mf, cmExecutionStatus& status,
+                                bool stopOnError) const
+{
+  std::vector<cmListFileProgramLoop> loops(this->Slots);
+  std::vector<unsigned int> active;
+
+  unsigned int pc = 0;
+  unsigned int const size =
+    static_cast<unsigned int>(this->Instructions.size());
+  while(pc < size && !cmSystemTools::GetFatalErrorOccured())
+    {
+    Instruction const& inst = this->Instructions[pc];
+    switch(inst.Op)
+      {
+      case Command:
+        {
+        cmExecutionStatus st;
+        if((!mf.ExecuteCommand(*inst.Function, st) ||
+            st.GetNestedError()) && stopOnError && inst.TopLevel)
+          {
+          cmListFileProgramRestore(mf, loops, active);
+          return false;
+          }
+        if(st.GetReturnInvoked())
+          {
+          cmListFileProgramRestore(mf, loops, active);
+          status.SetReturnInvoked(true);
+          return true;
+          }
+        pc = st.GetBreakInvoked()? inst.Target : pc+1;
+        }
+        break;
+      case If:
+        {
+        bool isTrue;
+        std::string error;
+        if(!this->EvaluateCondition(mf, inst, isTrue, error))
+          {
+          bool result;
+          if(!this->Replay(mf, inst, stopOnError, status, pc, result))
+            {
+            cmListFileProgramRestore(mf, loops, active);
+            return result;
+            }
+          break;
+          }
+        pc = isTrue? pc+1 : inst.Target;
+        }
+        break;
+      case ElseIf:
+        {
+        bool isTrue;
+        std::string error;
+        if(!this->EvaluateCondition(mf, inst, isTrue, error))
+          {
+          // The interpreter reports the error and runs nothing more of
+          // the block.  Nothing in it has run yet and the conditions
+          // before this one are false, so let it run the block from
+          // its if() to get the same errors and effects.
+          bool result;
+          if(!this->Replay(mf, this->Instructions[inst.Open], stopOnError,
+                           status, pc, result))
+            {
+            cmListFileProgramRestore(mf, loops, active);
+            return result;
+            }
+          break;
+          }
+        pc = isTrue? pc+1 : inst.Target;
+        }
+        break;
+      case While:
+        {
+        // The while blocker ignores errors in the condition.
+        bool isTrue;
+        std::string error;
+        if(!this->EvaluateCondition(mf, inst, isTrue, error))
+          {
+          isTrue = false;
+          }
+        pc = isTrue? pc+1 : inst.Target;
+        }
+        break;
+      case ForEach:
+        {
+        std::vector<std::string> expandedArguments;
+        std::vector<std::string> loopArgs;
+        std::string error;
+        bool ok;
+        {
+        cmListFileProgramTimer timer(mf, *inst.Function);
+        mf.ExpandArguments(inst.Function->Arguments, expandedArguments);
+        ok = cmForEachCommand::GetLoopArguments(mf, expandedArguments,
+                                                loopArgs, error);
+        }
+        if(!ok)
+          {
+          bool result;
+          if(!this->Replay(mf, inst, stopOnError, status, pc, result))
+            {
+            cmListFileProgramRestore(mf, loops, active);
+            return result;
+            }
+          break;
+          }
+        cmListFileProgramLoop& loop = loops[inst.Slot];
+        loop.Args.swap(loopArgs);
+        const char* oldDef = mf.GetDefinition(loop.Args[0].c_str());
+        loop.OldDef = oldDef? oldDef : "";
+        active.push_back(inst.Slot);
+        if(loop.Args.size() > 1)
+          {
+          mf.AddDefinition(loop.Args[0].c_str(), loop.Args[1].c_str());
+          loop.Next = 2;
+          pc = pc+1;
+          }
+        else
+          {
+          pc = inst.Target;
+          }
+        }
+        break;
+      case ForEachNext:
+        {
+        cmListFileProgramLoop& loop = loops[inst.Slot];
+        if(loop.Next < loop.Args.size())
+          {
+          mf.AddDefinition(loop.Args[0].c_str(),
+                           loop.Args[loop.Next++].c_str());
+          pc = inst.Target;
+          }
+        else
+          {
+          pc = pc+1;
+          }
+        }
+        break;
+      case ForEachEnd:
+        {
+        cmListFileProgramLoop& loop = loops[inst.Slot];
+        mf.AddDefinition(loop.Args[0].c_str(), loop.OldDef.c_str());
+        active.pop_back();
+        pc = pc+1;
+        }
+        break;
+      case Jump:
+        pc = inst.Target;
+        break;
+      }
+    }
+  cmListFileProgramRestore(mf, loops, active);
+  return true;
+}
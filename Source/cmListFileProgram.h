@@ -0,0 +1,114 @@
+/*=========================================================================
+
+  Program:   CMake - Cross-Platform Makefile Generator
+  Module:    $RCSfile: cmListFileProgram.h,v $
+  Language:  C++
+  Date:      $Date: 2008/06/05 16:40:12 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) 2002 Kitware, Inc., Insight Consortium.  All rights reserved.
+  See Copyright.txt or http://www.cmake.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef cmListFileProgram_h
+#define cmListFileProgram_h
+
+#include "cmStandardIncludes.h"
+
+#include "cmListFileCache.h"
+
+class cmExecutionStatus;
+class cmMakefile;
+
+/** \class cmListFileProgram
+ * \brief Compiled form of a sequence of listfile commands.
+ *
+ * The interpreter runs if(), foreach() and while() through function
+ * blockers that record the commands of a block and replay them one by
+ * one.  This lowers the same commands once into a flat instruction
+ * array in which the control flow commands become conditional jumps.
+ * Blocks whose interpretation depends on the order in which
+ * the blockers see their commands, such as mismatched end commands,
+ * are not compiled and the caller keeps using the interpreter.  When
+ * an if() or foreach() fails at run time no blocker would record its
+ * block, so its commands are run one by one like the interpreter does.
+ * When an elseif() fails the interpreter abandons the rest of its
+ * block, so the block is run by the interpreter from its if().
+ * Under --profile the commands opening or continuing a compiled block
+ * are timed while their condition or loop arguments are evaluated.
+ *
+ * The bodies of function() and macro() definitions are kept as plain
+ * commands so their blockers record them just like the interpreter.
+ */
+class cmListFileProgram
+{
+public:
+  cmListFileProgram();
+
+  /** Compile the given commands.  They must outlive this object.
+      Returns false if they must be interpreted instead.  */
+  bool Compile(std::vector<cmListFileFunction> const& functions);
+
+  /** Whether the last Compile succeeded.  */
+  bool IsValid() const { return this->Valid; }
+
+  /**
+   * Execute the program in the given makefile.  A return() is reported
+   * through the status.  If stopOnError is true execution stops at the
+   * first failing command outside of a block, as in a function body,
+   * and false is returned.
+   */
+  bool Execute(cmMakefile& mf, cmExecutionStatus& status,
+               bool stopOnError) const;
+
+private:
+  enum OpCode
+    {
+    Command,     // Execute Function; on break() jump to Target.
+    If,          // Jump to Target if the condition is false.
+    ElseIf,      // Jump to Target if the condition is false.
+    While,       // Jump to Target if the condition is false.
+    ForEach,     // Start loop Slot, jump to Target if it is empty.
+    ForEachNext, // Continue loop Slot at Target if values remain.
+    ForEachEnd,  // Restore the loop variable of loop Slot.
+    Jump         // Jump to Target.
+    };
+
+  struct Instruction
+  {
+    OpCode Op;
+    cmListFileFunction const* Function;
+    unsigned int Target;
+    unsigned int Slot;
+    bool TopLevel;
+    // For If and ForEach, the command closing the block, the first
+    // instruction after it, and where a break() in the block goes if
+    // the opening command fails, or 0 if the break() is ignored.
+    cmListFileFunction const* Close;
+    unsigned int End;
+    unsigned int Exit;
+    // For ElseIf, the If of its block.
+    unsigned int Open;
+  };
+  std::vector<Instruction> Instructions;
+  unsigned int Slots;
+  bool Valid;
+
+  struct Block;
+  unsigned int Emit(OpCode op, cmListFileFunction const* function,
+                    bool topLevel);
+  bool CompileFailed();
+  void AddBreak(std::vector<Block>& stack, unsigned int index);
+  void SetBreakTarget(unsigned int index, unsigned int target);
+  bool Replay(cmMakefile& mf, Instruction const& inst, bool stopOnError,
+              cmExecutionStatus& status, unsigned int& pc,
+              bool& result) const;
+  bool EvaluateCondition(cmMakefile& mf, Instruction const& inst,
+                         bool& isTrue, std::string& error) const;
+};
+
+#endif
@@ -1617,6 +1617,110 @@ void cmLocalGenerator::OutputLinkLibraries(std::ostream& fout,
     }
 }
 
+//----------------------------------------------------------------------------
+bool cmLocalGenerator::GetExecutableBuildCommands(const char* lang,
+                                                  const char* source,
+                                                  const char* object,
+                                                  const char* target,
+                                                  const char* langFlags,
+                                                  const char* compileFlags,
+                                                  const char* defines,
+                                                  std::vector<std::string>&
+                                                  commands)
+{
+  std::string compileRuleVar = "CMAKE_";
+  compileRuleVar += lang;
+  compileRuleVar += "_COMPILE_OBJECT";
+  std::string linkRuleVar = "CMAKE_";
+  linkRuleVar += lang;
+  linkRuleVar += "_LINK_EXECUTABLE";
+  const char* compileRule =
+    this->Makefile->GetDefinition(compileRuleVar.c_str());
+  const char* linkRule = this->Makefile->GetDefinition(linkRuleVar.c_str());
+  if(!compileRule || !linkRule)
+    {
+    return false;
+    }
+
+  std::string shellSource = this->Convert(source, NONE, SHELL);
+  std::string shellObject = this->Convert(object, NONE, SHELL);
+  std::string shellObjectDir =
+    this->Convert(cmSystemTools::GetFilenamePath(object).c_str(),
+                  NONE, SHELL);
+  std::string shellTarget = this->Convert(target, NONE, SHELL);
+  std::string pdb = cmSystemTools::GetFilenamePath(target);
+  pdb += "/";
+  pdb += cmSystemTools::GetFilenameWithoutLastExtension(target);
+  pdb += ".pdb";
+  std::string shellPDB = this->Convert(pdb.c_str(), NONE, SHELL);
+
+  std::string flags = langFlags;
+  this->AppendFlags(flags, compileFlags);
+  RuleVariables compileVars;
+  compileVars.Language = lang;
+  compileVars.TargetPDB = shellPDB.c_str();
+  compileVars.Source = shellSource.c_str();
+  compileVars.Object = shellObject.c_str();
+  compileVars.ObjectDir = shellObjectDir.c_str();
+  compileVars.Flags = flags.c_str();
+  compileVars.Defines = defines;
+  std::vector<std::string> compileCommands;
+  cmSystemTools::ExpandListArgument(compileRule, compileCommands);
+  for(std::vector<std::string>::iterator i = compileCommands.begin();
+      i != compileCommands.end(); ++i)
+    {
+    this->ExpandRuleVariables(*i, compileVars);
+    commands.push_back(*i);
+    }
+
+  // The link flags of an executable; see the makefile executable target
+  // generator.
+  std::string linkFlags;
+  std::string sharedFlagsVar = "CMAKE_SHARED_LIBRARY_";
+  sharedFlagsVar += lang;
+  sharedFlagsVar += "_FLAGS";
+  this->AppendFlags(linkFlags,
+                    this->Makefile->GetDefinition(sharedFlagsVar.c_str()));
+  this->AppendFlags(linkFlags,
+                    this->Makefile->GetDefinition("CMAKE_EXE_LINKER_FLAGS"));
+  this->AppendFlags(linkFlags,
+                    this->Makefile->GetDefinition("CMAKE_CREATE_CONSOLE_EXE"));
+  std::string linkLibsVar = "CMAKE_SHARED_LIBRARY_LINK_";
+  linkLibsVar += lang;
+  linkLibsVar += "_FLAGS";
+  std::string linkLibs =
+    this->Makefile->GetSafeDefinition(linkLibsVar.c_str());
+  linkLibs += " ";
+  std::string standardLibsVar = "CMAKE_";
+  standardLibsVar += lang;
+  standardLibsVar += "_STANDARD_LIBRARIES";
+  if(const char* stdLibs =
+     this->Makefile->GetDefinition(standardLibsVar.c_str()))
+    {
+    linkLibs += stdLibs;
+    linkLibs += " ";
+    }
+  RuleVariables linkVars;
+  linkVars.Language = lang;
+  linkVars.Objects = shellObject.c_str();
+  linkVars.Target = shellTarget.c_str();
+  linkVars.TargetPDB = shellPDB.c_str();
+  linkVars.TargetVersionMajor = "0";
+  linkVars.TargetVersionMinor = "0";
+  linkVars.LinkLibraries = linkLibs.c_str();
+  linkVars.Flags = langFlags;
+  linkVars.LinkFlags = linkFlags.c_str();
+  std::vector<std::string> linkCommands;
+  cmSystemTools::ExpandListArgument(linkRule, linkCommands);
+  for(std::vector<std::string>::iterator i = linkCommands.begin();
+      i != linkCommands.end(); ++i)
+    {
+    this->ExpandRuleVariables(*i, linkVars);
+    commands.push_back(*i);
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 void cmLocalGenerator::AddLanguageFlags(std::string& flags,
                                         const char* lang,
@@ -163,6 +163,22 @@ public:
 
   ///! for existing files convert to output path and short path if spaces
   std::string ConvertToOutputForExisting(const char* p);
+
+  /**
+   * Get the commands that compile one source file and link it into an
+   * executable with the CMAKE_<LANG>_COMPILE_OBJECT and
+   * CMAKE_<LANG>_LINK_EXECUTABLE rules, as the makefile generators
+   * write them for a target without properties or libraries.  The
+   * language flags are given to both rules, the defines and compile
+   * flags only to the compiler.  Paths must be full paths.  Returns
+   * false if the language does not have both rules.
+   */
+  bool GetExecutableBuildCommands(const char* lang, const char* source,
+                                  const char* object, const char* target,
+                                  const char* langFlags,
+                                  const char* compileFlags,
+                                  const char* defines,
+                                  std::vector<std::string>& commands);
   
   /** Called from command-line hook to clear dependencies.  */
   virtual void ClearDependencies(cmMakefile* /* mf */, 
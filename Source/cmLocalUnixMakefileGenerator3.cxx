@@ -536,6 +536,19 @@ void cmLocalUnixMakefileGenerator3::WriteDirectoryInformationFile()
   infoFileStream
     << "SET(CMAKE_CXX_INCLUDE_REGEX_COMPLAIN "
     "${CMAKE_C_INCLUDE_REGEX_COMPLAIN})\n";
+
+  // Store the limit of threads scanning dependencies, if any.
+  if(const char* jobs =
+     this->Makefile->GetDefinition("CMAKE_DEPENDS_SCAN_JOBS"))
+    {
+    infoFileStream
+      << "\n"
+      << "# The number of threads scanning dependencies at once.\n"
+      << "SET(CMAKE_DEPENDS_SCAN_JOBS ";
+    this->WriteCMakeArgument(infoFileStream, jobs);
+    infoFileStream
+      << ")\n";
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -1503,10 +1516,16 @@ cmLocalUnixMakefileGenerator3
       includeCacheFileName += ".includecache";
       
       // TODO: Handle RC (resource files) dependencies correctly.
-      scanner = new cmDependsC(includes,
-                               includeRegexScan.c_str(),
-                               includeRegexComplain.c_str(),
-                               includeCacheFileName);
+      cmDependsC* scannerC = new cmDependsC(includes,
+                                            includeRegexScan.c_str(),
+                                            includeRegexComplain.c_str(),
+                                            includeCacheFileName);
+      const char* jobs = mf->GetDefinition("CMAKE_DEPENDS_SCAN_JOBS");
+      if(haveDirectoryInfo && jobs && atoi(jobs) > 0)
+        {
+        scannerC->SetScanJobs(static_cast<unsigned int>(atoi(jobs)));
+        }
+      scanner = scannerC;
       }
 #ifdef CMAKE_BUILD_WITH_CMAKE
     else if(lang == "Fortran")
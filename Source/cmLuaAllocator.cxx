@@ -0,0 +1,189 @@
+/*=========================================================================
+
+  Program:   CMake - Cross-Platform Makefile Generator
+  Module:    $RCSfile: cmLuaAllocator.cxx,v $
+  Language:  C++
+  Date:      $Date: 2008/06/03 09:21:17 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) 2002 Kitware, Inc., Insight Consortium.  All rights reserved.
+  See Copyright.txt or http://www.cmake.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "cmLuaAllocator.h"
+
+#include "cmSystemTools.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------
+cmLuaAllocator::cmLuaAllocator()
+{
+  for(int i=0; i < NumClasses; ++i)
+    {
+    this->FreeLists[i] = 0;
+    }
+  this->ChunkPos = 0;
+  this->ChunkEnd = 0;
+  this->CurrentBytes = 0;
+  this->PeakBytes = 0;
+  this->Allocations = 0;
+  this->FreedBytes = 0;
+  this->FreeRun = 0;
+  this->FreeRunStart = 0;
+  this->SweepTime = 0;
+  this->Sweeps = 0;
+}
+
+//----------------------------------------------------------------------------
+cmLuaAllocator::~cmLuaAllocator()
+{
+  for(std::vector<char*>::iterator i = this->Chunks.begin();
+      i != this->Chunks.end(); ++i)
+    {
+    free(*i);
+    }
+}
+
+//----------------------------------------------------------------------------
+void* cmLuaAllocator::Alloc(void* ud, void* ptr, size_t osize, size_t nsize)
+{
+  cmLuaAllocator* self = static_cast<cmLuaAllocator*>(ud);
+  if(nsize == 0)
+    {
+    if(ptr)
+      {
+      // a lone free costs no clock read
+      if(++self->FreeRun == 2)
+        {
+        self->FreeRunStart = cmSystemTools::GetTime();
+        }
+      self->Free(ptr, osize);
+      self->CurrentBytes -= osize;
+      self->FreedBytes += osize;
+      }
+    return 0;
+    }
+  if(self->FreeRun)
+    {
+    self->EndFreeRun();
+    }
+
+  void* result = ptr? self->Reallocate(ptr, osize, nsize)
+                    : self->Allocate(nsize);
+  if(result)
+    {
+    // Lua passes osize 0 for new blocks.
+    self->CurrentBytes += nsize - (ptr? osize : 0);
+    if(self->CurrentBytes > self->PeakBytes)
+      {
+      self->PeakBytes = self->CurrentBytes;
+      }
+    }
+  return result;
+}
+
+//----------------------------------------------------------------------------
+void cmLuaAllocator::EndFreeRun()
+{
+  if(this->FreeRun >= 2)
+    {
+    this->SweepTime += cmSystemTools::GetTime() - this->FreeRunStart;
+    ++this->Sweeps;
+    }
+  this->FreeRun = 0;
+}
+
+//----------------------------------------------------------------------------
+void* cmLuaAllocator::Allocate(size_t size)
+{
+  ++this->Allocations;
+  if(size > MaxPooledSize)
+    {
+    return malloc(size);
+    }
+
+  size_t c = GetClass(size);
+  if(Block* b = this->FreeLists[c])
+    {
+    this->FreeLists[c] = b->Next;
+    return b;
+    }
+
+  size_t bytes = (c + 1) * Granularity;
+  if(this->ChunkPos + bytes > this->ChunkEnd)
+    {
+    // The tail of the old chunk is lost; at most MaxPooledSize bytes.
+    char* chunk = static_cast<char*>(malloc(ChunkSize));
+    if(!chunk)
+      {
+      return 0;
+      }
+    this->Chunks.push_back(chunk);
+    this->ChunkPos = chunk;
+    this->ChunkEnd = chunk + ChunkSize;
+    }
+  void* result = this->ChunkPos;
+  this->ChunkPos += bytes;
+  return result;
+}
+
+//----------------------------------------------------------------------------
+bool cmLuaAllocator::HasPooledBlock(size_t size) const
+{
+  size_t c = GetClass(size);
+  return (this->FreeLists[c] ||
+          this->ChunkPos + (c + 1) * Granularity <= this->ChunkEnd);
+}
+
+//----------------------------------------------------------------------------
+void cmLuaAllocator::Free(void* ptr, size_t size)
+{
+  if(size > MaxPooledSize)
+    {
+    free(ptr);
+    return;
+    }
+  Block* b = static_cast<Block*>(ptr);
+  size_t c = GetClass(size);
+  b->Next = this->FreeLists[c];
+  this->FreeLists[c] = b;
+}
+
+//----------------------------------------------------------------------------
+void* cmLuaAllocator::Reallocate(void* ptr, size_t osize, size_t nsize)
+{
+  // Lua requires that shrinking a block never fails.
+  if(osize > MaxPooledSize && nsize > MaxPooledSize)
+    {
+    void* result = realloc(ptr, nsize);
+    return (result || nsize > osize)? result : ptr;
+    }
+  if(osize <= MaxPooledSize && nsize <= MaxPooledSize &&
+     GetClass(osize) == GetClass(nsize))
+    {
+    return ptr;
+    }
+
+  // A shrink that would need a new chunk keeps the block where it is.
+  // It is later freed into the free list of its new, smaller class, so
+  // a heap block kept this way serves the pool until the process exits.
+  if(nsize <= osize && !this->HasPooledBlock(nsize))
+    {
+    return ptr;
+    }
+
+  // Moving between the pool and the heap or between size classes.
+  void* result = this->Allocate(nsize);
+  if(result)
+    {
+    memcpy(result, ptr, osize < nsize? osize : nsize);
+    this->Free(ptr, osize);
+    }
+  return result;
+}
@@ -0,0 +1,88 @@
+/*=========================================================================
+
+  Program:   CMake - Cross-Platform Makefile Generator
+  Module:    $RCSfile: cmLuaAllocator.h,v $
+  Language:  C++
+  Date:      $Date: 2008/06/03 09:21:17 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) 2002 Kitware, Inc., Insight Consortium.  All rights reserved.
+  See Copyright.txt or http://www.cmake.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef cmLuaAllocator_h
+#define cmLuaAllocator_h
+
+#include "cmStandardIncludes.h"
+
+/** \class cmLuaAllocator
+ * \brief Pool allocator and heap accounting for the Lua states.
+ *
+ * Lua allocates and frees huge numbers of small strings, tables and
+ * closures while listfiles run.  Blocks up to MaxPooledSize bytes are
+ * carved from large chunks and recycled through per-size free lists;
+ * larger blocks go to the C heap.  The chunks are only released when
+ * the allocator is destroyed after the last Lua state is closed, so
+ * the pool behaves like an arena for the configure run.
+ *
+ * The allocator also tracks the current and peak number of bytes Lua
+ * holds, the number of blocks it allocated and the bytes it freed.
+ * The incremental collector frees dead objects in runs between the
+ * allocations of the running code.  Timing each free would cost more
+ * than the free, so only runs of two frees or more are timed, from
+ * their second free to the next allocation.  That is the sweep work of
+ * the collector; its marking frees nothing and is not measured.
+ */
+class cmLuaAllocator
+{
+public:
+  cmLuaAllocator();
+  ~cmLuaAllocator();
+
+  /** The lua_Alloc function; pass the allocator as user data.  */
+  static void* Alloc(void* ud, void* ptr, size_t osize, size_t nsize);
+
+  size_t GetCurrentBytes() const { return this->CurrentBytes; }
+  size_t GetPeakBytes() const { return this->PeakBytes; }
+  unsigned long GetAllocations() const { return this->Allocations; }
+  size_t GetFreedBytes() const { return this->FreedBytes; }
+
+  /** Time spent in timed runs of frees, and the number of runs.  */
+  double GetSweepTime() const { return this->SweepTime; }
+  unsigned long GetSweeps() const { return this->Sweeps; }
+
+private:
+  enum { Granularity = 8, MaxPooledSize = 256,
+         NumClasses = MaxPooledSize / Granularity,
+         ChunkSize = 64 * 1024 };
+
+  void* Allocate(size_t size);
+  void Free(void* ptr, size_t size);
+  void* Reallocate(void* ptr, size_t osize, size_t nsize);
+  bool HasPooledBlock(size_t size) const;
+  void EndFreeRun();
+
+  static size_t GetClass(size_t size)
+    { return (size + Granularity - 1) / Granularity - 1; }
+
+  struct Block { Block* Next; };
+  Block* FreeLists[NumClasses];
+  std::vector<char*> Chunks;
+  char* ChunkPos;
+  char* ChunkEnd;
+
+  size_t CurrentBytes;
+  size_t PeakBytes;
+  unsigned long Allocations;
+  size_t FreedBytes;
+  unsigned long FreeRun;
+  double FreeRunStart;
+  double SweepTime;
+  unsigned long Sweeps;
+};
+
+#endif
@@ -30,6 +30,11 @@ bool cmLuaCommand
     return false;
   }
 
+  // cmake.* calls made by the code act on this makefile
+  lua_State* L = Makefile->GetLuaState();
+  cmMakefile* previousMF =
+    Makefile->GetCMakeInstance()->SetCurrentLuaMakefile(L, Makefile);
+
   int error = 0;
   if (args.size() == 2 && args[0] == "FILE") 
     {
@@ -47,9 +52,16 @@ bool cmLuaCommand
       str += *it;
       }
 
-    error = luaL_dostring(Makefile->GetCMakeInstance()->GetLuaState(), str.c_str());
+    error = luaL_dostring(L, str.c_str());
+    if (error != 0)
+      {
+      std::cerr << "-- " << lua_tostring(L, -1) << std::endl;
+      lua_pop(L, 1);
+      }
     }
 
+  Makefile->GetCMakeInstance()->SetCurrentLuaMakefile(L, previousMF);
+
   if (error != 0) 
     {
     SetError("Error when processing Lua code");
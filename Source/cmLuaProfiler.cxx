@@ -0,0 +1,373 @@
+/*=========================================================================
+
+  Program:   CMake - Cross-Platform Makefile Generator
+  Module:    $RCSfile: cmLuaProfiler.cxx,v $
+  Language:  C++
+  Date:      $Date: 2008/06/02 14:12:40 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) 2002 Kitware, Inc., Insight Consortium.  All rights reserved.
+  See Copyright.txt or http://www.cmake.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "cmLuaProfiler.h"
+
+#include "cmSystemTools.h"
+#include "cmGeneratedFileStream.h"
+#include "cmLuaUtils.h"
+
+extern "C" {
+#include "../Utilities/lua/src/lobject.h"
+}
+
+#include <algorithm>
+
+cmLuaProfiler* cmLuaProfiler::Instance = 0;
+
+//----------------------------------------------------------------------------
+cmLuaProfiler::cmLuaProfiler(const char* fname): FileName(fname)
+{
+  this->LastState = 0;
+  this->LastStack = 0;
+  cmLuaProfiler::Instance = this;
+}
+
+//----------------------------------------------------------------------------
+cmLuaProfiler::~cmLuaProfiler()
+{
+  if(cmLuaProfiler::Instance == this)
+    {
+    cmLuaProfiler::Instance = 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmLuaProfiler::Attach(lua_State* L)
+{
+  lua_sethook(L, &cmLuaProfiler::Hook, LUA_MASKCALL | LUA_MASKRET, 0);
+}
+
+//----------------------------------------------------------------------------
+void cmLuaProfiler::Hook(lua_State* L, lua_Debug* ar)
+{
+  cmLuaProfiler* self = cmLuaProfiler::Instance;
+  if(!self)
+    {
+    return;
+    }
+  switch(ar->event)
+    {
+    case LUA_HOOKCALL:    self->OnCall(L); break;
+    case LUA_HOOKRET:     self->OnReturn(L, false); break;
+    case LUA_HOOKTAILRET: self->OnReturn(L, true); break;
+    default: break;
+    }
+}
+
+//----------------------------------------------------------------------------
+cmLuaProfiler::FrameStack& cmLuaProfiler::GetStack(lua_State* L)
+{
+  // Nearly all events come from the same state, so avoid the map
+  // lookup unless a coroutine shows up.
+  if(L != this->LastState)
+    {
+    this->LastState = L;
+    this->LastStack = &this->Stacks[L];
+    }
+  return *this->LastStack;
+}
+
+//----------------------------------------------------------------------------
+cmLuaProfiler::Entry* cmLuaProfiler::GetFunction(lua_State* L)
+{
+  lua_Debug ar;
+  if(!lua_getstack(L, 0, &ar) || !lua_getinfo(L, "f", &ar))
+    {
+    return 0;
+    }
+  Entry* e = lua_iscfunction(L, -1)? this->GetCFunction(L, ar)
+                                    : this->GetLuaFunction(L, ar);
+  lua_pop(L, 1);
+  return e;
+}
+
+//----------------------------------------------------------------------------
+cmLuaProfiler::Entry* cmLuaProfiler::GetLuaFunction(lua_State* L,
+                                                    lua_Debug& ar)
+{
+  // Every closure of a Lua function shares its prototype.  The memory
+  // of a collected prototype may be reused by another one; its chunk
+  // name and lines tell them apart.
+  Proto const* p = static_cast<Closure const*>(lua_topointer(L, -1))->l.p;
+  std::map<const void*, Entry*>::iterator i = this->Functions.find(p);
+  if(i != this->Functions.end() && i->second->Chunk == p->source &&
+     i->second->Line == p->linedefined &&
+     i->second->LastLine == p->lastlinedefined)
+    {
+    return i->second;
+    }
+
+  this->Entries.push_back(Entry());
+  Entry& e = this->Entries.back();
+  e.Chunk = p->source;
+  e.Line = p->linedefined;
+  e.LastLine = p->lastlinedefined;
+  lua_getinfo(L, "S", &ar);
+  // file chunks are named "@<path>"
+  e.Source = ar.source[0] == '@'? ar.source+1 : ar.short_src;
+  // "name:chunk:line", the name is empty for a main chunk or a
+  // function called without one
+  e.Name = LuaUtils_GetLocationString(L, 0);
+  if(!e.Name.empty() && e.Name[0] == ':')
+    {
+    e.Name.insert(0, ar.what[0] == 'm'? "main" : "?");
+    }
+  this->Functions[p] = &e;
+  return &e;
+}
+
+//----------------------------------------------------------------------------
+cmLuaProfiler::Entry* cmLuaProfiler::GetCFunction(lua_State* L,
+                                                  lua_Debug& ar)
+{
+  // The cmake.* bindings live as long as the state and are known by
+  // their closure.  Other C functions are known by their code.
+  const void* closure = lua_topointer(L, -1);
+  std::map<const void*, Entry*>::iterator i = this->CFunctions.find(closure);
+  if(i != this->CFunctions.end())
+    {
+    return i->second;
+    }
+
+  // A binding has the command name and the cmake instance as upvalues.
+  std::string command;
+  if(lua_getupvalue(L, -1, 2))
+    {
+    bool binding = lua_islightuserdata(L, -1) != 0;
+    lua_pop(L, 1);
+    if(binding && lua_getupvalue(L, -1, 1))
+      {
+      if(lua_type(L, -1) == LUA_TSTRING)
+        {
+        command = lua_tostring(L, -1);
+        }
+      lua_pop(L, 1);
+      }
+    }
+  const void* key = closure;
+  if(command.empty())
+    {
+    key = reinterpret_cast<const void*>(lua_tocfunction(L, -1));
+    i = this->CFunctions.find(key);
+    if(i != this->CFunctions.end())
+      {
+      return i->second;
+      }
+    }
+
+  this->Entries.push_back(Entry());
+  Entry& e = this->Entries.back();
+  e.Source = "[C]";
+  if(!command.empty())
+    {
+    e.Name = "cmake.";
+    e.Name += command;
+    }
+  else if(lua_getinfo(L, "n", &ar) && ar.name)
+    {
+    e.Name = "[C] ";
+    e.Name += ar.name;
+    }
+  else
+    {
+    // called without a name, for example as a metamethod
+    char buf[64];
+    sprintf(buf, "[C] %p", key);
+    e.Name = buf;
+    }
+  this->CFunctions[key] = &e;
+  return &e;
+}
+
+//----------------------------------------------------------------------------
+void cmLuaProfiler::OnCall(lua_State* L)
+{
+  Entry* e = this->GetFunction(L);
+  if(!e)
+    {
+    return;
+    }
+
+  ++e->Calls;
+  ++e->Active;
+  Frame f;
+  f.Func = e;
+  f.Children = 0;
+  f.Start = cmSystemTools::GetTime();
+  this->GetStack(L).push_back(f);
+}
+
+//----------------------------------------------------------------------------
+void cmLuaProfiler::OnReturn(lua_State* L, bool tail)
+{
+  double now = cmSystemTools::GetTime();
+  FrameStack& stack = this->GetStack(L);
+  if(stack.empty())
+    {
+    return;
+    }
+
+  // The frame of a tail-called function is gone, there is nothing to
+  // match against.
+  if(tail)
+    {
+    this->PopFrame(stack, now);
+    return;
+    }
+
+  Entry* e = this->GetFunction(L);
+  if(!e)
+    {
+    return;
+    }
+
+  // A Lua error unwinds without return events.  Close every frame
+  // above the returning one so the error does not leak time into the
+  // caller.  A function entered before the hook was installed has no
+  // frame at all.
+  FrameStack::size_type n = stack.size();
+  while(n > 0 && stack[n-1].Func != e)
+    {
+    --n;
+    }
+  if(n == 0)
+    {
+    return;
+    }
+  while(stack.size() >= n)
+    {
+    this->PopFrame(stack, now);
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmLuaProfiler::PopFrame(FrameStack& stack, double now)
+{
+  Frame f = stack.back();
+  stack.pop_back();
+  double total = now - f.Start;
+  Entry* e = f.Func;
+  e->Exclusive += total - f.Children;
+  if(--e->Active == 0)
+    {
+    e->Inclusive += total;
+    }
+  if(!stack.empty())
+    {
+    Frame& parent = stack.back();
+    parent.Children += total;
+    Edge& edge = parent.Func->Callees[e];
+    ++edge.Calls;
+    edge.Inclusive += total;
+    }
+}
+
+//----------------------------------------------------------------------------
+bool cmLuaProfiler::WriteReport()
+{
+  // Frames still open (the hook was attached inside a running chunk)
+  // are closed at the time of the report.
+  double now = cmSystemTools::GetTime();
+  for(std::map<lua_State*, FrameStack>::iterator i = this->Stacks.begin();
+      i != this->Stacks.end(); ++i)
+    {
+    while(!i->second.empty())
+      {
+      this->PopFrame(i->second, now);
+      }
+    }
+
+  cmGeneratedFileStream fout(this->FileName.c_str());
+  if(!fout)
+    {
+    return false;
+    }
+  if(this->FileName.find("callgrind") != std::string::npos)
+    {
+    return this->WriteCallgrind(fout);
+    }
+  return this->WriteFlat(fout);
+}
+
+//----------------------------------------------------------------------------
+struct cmLuaProfilerEntryCompare
+{
+  template <class T>
+  bool operator()(T const* l, T const* r) const
+    {
+    return l->Exclusive > r->Exclusive;
+    }
+};
+
+//----------------------------------------------------------------------------
+bool cmLuaProfiler::WriteFlat(std::ostream& fout)
+{
+  std::vector<Entry*> entries;
+  double total = 0;
+  unsigned long calls = 0;
+  for(std::list<Entry>::iterator i = this->Entries.begin();
+      i != this->Entries.end(); ++i)
+    {
+    entries.push_back(&*i);
+    total += i->Exclusive;
+    calls += i->Calls;
+    }
+  std::sort(entries.begin(), entries.end(), cmLuaProfilerEntryCompare());
+
+  char buf[128];
+  sprintf(buf, "%.6f", total);
+  fout << "Lua profile: " << buf << " s in " << calls << " calls\n\n";
+  sprintf(buf, "%12s %12s %10s  ", "exclusive", "inclusive", "calls");
+  fout << buf << "function\n";
+  for(std::vector<Entry*>::const_iterator i = entries.begin();
+      i != entries.end(); ++i)
+    {
+    sprintf(buf, "%12.6f %12.6f %10lu  ",
+            (*i)->Exclusive, (*i)->Inclusive, (*i)->Calls);
+    fout << buf << (*i)->Name << "\n";
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool cmLuaProfiler::WriteCallgrind(std::ostream& fout)
+{
+  fout << "version: 1\n"
+       << "creator: cmake --profile-lua\n"
+       << "positions: line\n"
+       << "events: Microseconds\n";
+  for(std::list<Entry>::const_iterator i = this->Entries.begin();
+      i != this->Entries.end(); ++i)
+    {
+    Entry const& e = *i;
+    fout << "\nfl=" << e.Source << "\n"
+         << "fn=" << e.Name << "\n"
+         << e.Line << " "
+         << static_cast<unsigned long>(e.Exclusive * 1000000) << "\n";
+    for(std::map<Entry*, Edge>::const_iterator c = e.Callees.begin();
+        c != e.Callees.end(); ++c)
+      {
+      fout << "cfl=" << c->first->Source << "\n"
+           << "cfn=" << c->first->Name << "\n"
+           << "calls=" << c->second.Calls << " " << c->first->Line << "\n"
+           << e.Line << " "
+           << static_cast<unsigned long>(c->second.Inclusive * 1000000)
+           << "\n";
+      }
+    }
+  return true;
+}
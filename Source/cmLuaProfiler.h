@@ -0,0 +1,115 @@
+/*=========================================================================
+
+  Program:   CMake - Cross-Platform Makefile Generator
+  Module:    $RCSfile: cmLuaProfiler.h,v $
+  Language:  C++
+  Date:      $Date: 2008/06/02 14:12:40 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) 2002 Kitware, Inc., Insight Consortium.  All rights reserved.
+  See Copyright.txt or http://www.cmake.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef cmLuaProfiler_h
+#define cmLuaProfiler_h
+
+#include "cmStandardIncludes.h"
+
+struct lua_State;
+struct lua_Debug;
+
+/** \class cmLuaProfiler
+ * \brief Measure time spent in Lua functions during configure.
+ *
+ * cmLuaProfiler installs a call/return hook on each Lua state it is
+ * attached to and aggregates the call count, inclusive time and
+ * exclusive time of every Lua function and cmake.* command.  Only call
+ * and return events are hooked so the overhead stays small enough to
+ * leave profiling enabled on a continuous build.  All closures of one
+ * Lua function definition share an entry, and no function is kept
+ * alive by the profiler.
+ *
+ * The report is written in callgrind format when the output file name
+ * contains "callgrind", and as a flat text table sorted by exclusive
+ * time otherwise.
+ */
+class cmLuaProfiler
+{
+public:
+  cmLuaProfiler(const char* fname);
+  ~cmLuaProfiler();
+
+  /** Install the profiling hook on the given state.  */
+  void Attach(lua_State* L);
+
+  /** Write the collected data to the output file.  */
+  bool WriteReport();
+
+  const char* GetFileName() const { return this->FileName.c_str(); }
+
+private:
+  struct Entry;
+  struct Edge
+  {
+    Edge(): Calls(0), Inclusive(0) {}
+    unsigned long Calls;
+    double Inclusive;
+  };
+  struct Entry
+  {
+    Entry(): Chunk(0), Line(0), LastLine(0), Calls(0), Active(0),
+             Inclusive(0), Exclusive(0) {}
+    std::string Name;
+    std::string Source;
+    // the interned chunk name and lines of a Lua function
+    const void* Chunk;
+    int Line;
+    int LastLine;
+    unsigned long Calls;
+    // number of frames of this function on the stack; inclusive time
+    // is only counted for the outermost one of a recursion
+    int Active;
+    double Inclusive;
+    double Exclusive;
+    std::map<Entry*, Edge> Callees;
+  };
+  struct Frame
+  {
+    Entry* Func;
+    double Start;
+    double Children;
+  };
+  typedef std::vector<Frame> FrameStack;
+
+  static void Hook(lua_State* L, lua_Debug* ar);
+  void OnCall(lua_State* L);
+  void OnReturn(lua_State* L, bool tail);
+  Entry* GetFunction(lua_State* L);
+  Entry* GetLuaFunction(lua_State* L, lua_Debug& ar);
+  Entry* GetCFunction(lua_State* L, lua_Debug& ar);
+  FrameStack& GetStack(lua_State* L);
+  void PopFrame(FrameStack& stack, double now);
+
+  bool WriteFlat(std::ostream& fout);
+  bool WriteCallgrind(std::ostream& fout);
+
+  std::string FileName;
+  std::list<Entry> Entries;
+  // Entries of Lua functions by prototype.
+  std::map<const void*, Entry*> Functions;
+  // Entries of cmake.* commands by closure and of other C functions
+  // by code.
+  std::map<const void*, Entry*> CFunctions;
+  std::map<lua_State*, FrameStack> Stacks;
+  lua_State* LastState;
+  FrameStack* LastStack;
+
+  // the hook is a plain C callback without user data
+  static cmLuaProfiler* Instance;
+};
+
+#endif
@@ -145,8 +145,17 @@ bool LuaUtils_RegisterFunc(lua_State* lua_state,
 	lua_pushstring( lua_state, function_name );               // stack: table string
 	// remember function_name as upvalue
 	lua_pushstring( lua_state, function_name );               // stack: table string string
-	// push closure on stack
-	lua_pushcclosure( lua_state, function_ptr, 1 );           // stack: table string func
+	// pass user_light_data as second upvalue, if given
+	if(NULL != user_light_data)
+	{
+		lua_pushlightuserdata( lua_state, user_light_data );  // stack: table string string ud
+		lua_pushcclosure( lua_state, function_ptr, 2 );       // stack: table string func
+	}
+	else
+	{
+		// push closure on stack
+		lua_pushcclosure( lua_state, function_ptr, 1 );       // stack: table string func
+	}
 	// add function to namespace table
 	lua_settable( lua_state, -3);                             // stack: table
 	
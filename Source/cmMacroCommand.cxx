@@ -18,25 +18,67 @@
 
 #include "cmake.h"
 
+// A macro body argument split at the references that an invocation
+// fills in, so that calling the macro needs no string searching.
+struct cmMacroArgumentTemplate
+{
+  struct Piece
+  {
+    enum Type { Literal, Formal, ArgC, ArgN, ArgV, ArgVN };
+    Piece(Type t, unsigned int i, std::string const& text):
+      PieceType(t), Index(i), Text(text) {}
+    Type PieceType;
+    unsigned int Index;
+    std::string Text;
+  };
+  cmMacroArgumentTemplate(): HasReferences(false), Nested(false) {}
+  std::vector<Piece> Pieces;
+
+  // True if the argument refers to the invocation arguments at all.
+  bool HasReferences;
+
+  // True if the argument also has ${ that is not one of our references,
+  // as in ${${var}_FOUND}.  A replacement may then form a new reference,
+  // which only the one-name-at-a-time replacement handles.
+  bool Nested;
+};
+
+// The recorded body of a macro.  A macro command is cloned for every
+// invocation, so the clones share one body instead of copying it.
+struct cmMacroBody
+{
+  cmMacroBody(): ReferenceCount(1) {}
+  int ReferenceCount;
+
+  std::vector<std::string> Args;
+  std::vector<cmListFileFunction> Functions;
+
+  // One template per argument of each command in Functions.
+  std::vector<std::vector<cmMacroArgumentTemplate> > Templates;
+};
+
 // define the class for macro commands
 class cmMacroHelperCommand : public cmCommand
 {
 public:
-  cmMacroHelperCommand() {}
+  cmMacroHelperCommand(cmMacroBody* body): Body(body) {}
 
   ///! clean up any memory allocated by the macro
-  ~cmMacroHelperCommand() {};
+  ~cmMacroHelperCommand()
+  {
+    if(--this->Body->ReferenceCount == 0)
+      {
+      delete this->Body;
+      }
+  }
 
   /**
    * This is a virtual constructor for the command.
    */
   virtual cmCommand* Clone()
   {
-    cmMacroHelperCommand *newC = new cmMacroHelperCommand;
-    // we must copy when we clone
-    newC->Args = this->Args;
-    newC->Functions = this->Functions;
-    return newC;
+    ++this->Body->ReferenceCount;
+    return new cmMacroHelperCommand(this->Body);
   }
 
   /**
@@ -51,13 +93,18 @@ public:
   virtual bool InvokeInitialPass(const std::vector<cmListFileArgument>& args, 
                                  cmExecutionStatus &);
 
+  /**
+   * Formal parameters are bound from the listfile arguments.
+   */
+  virtual bool AcceptsDirectArguments() { return false; }
+
   virtual bool InitialPass(std::vector<std::string> const&,
                            cmExecutionStatus &) { return false; };
 
   /**
    * The name of the command as specified in CMakeList.txt.
    */
-  virtual const char* GetName() { return this->Args[0].c_str(); }
+  virtual const char* GetName() { return this->Body->Args[0].c_str(); }
   
   /**
    * Succinct documentation.
@@ -79,10 +126,190 @@ public:
 
   cmTypeMacro(cmMacroHelperCommand, cmCommand);
 
-  std::vector<std::string> Args;
-  std::vector<cmListFileFunction> Functions;
+  /**
+   * Split the body arguments at the references to the macro arguments.
+   * Called once when the macro is defined.
+   */
+  static void CompileBody(cmMacroBody& body);
+
+private:
+  cmMacroBody* Body;
+
+  static void CompileArgument(cmMacroBody const& body,
+                              std::string const& value,
+                              cmMacroArgumentTemplate& t);
+  void ReplaceArguments(std::string& tmps,
+                        std::vector<std::string> const& expandedArgs,
+                        std::string const& argcDef,
+                        std::string& argnDef, bool& argnDefInitialized,
+                        std::string& argvDef, bool& argvDefInitialized);
 };
 
+static void cmMacroJoinArguments(std::vector<std::string> const& args,
+                                 std::vector<std::string>::size_type first,
+                                 std::string& out)
+{
+  for(std::vector<std::string>::size_type i = first; i < args.size(); ++i)
+    {
+    if(out.size() > 0)
+      {
+      out += ";";
+      }
+    out += args[i];
+    }
+}
+
+void cmMacroHelperCommand::CompileBody(cmMacroBody& body)
+{
+  body.Templates.clear();
+  body.Templates.resize(body.Functions.size());
+  for(unsigned int c = 0; c < body.Functions.size(); ++c)
+    {
+    std::vector<cmListFileArgument> const& fargs =
+      body.Functions[c].Arguments;
+    body.Templates[c].resize(fargs.size());
+    for(unsigned int a = 0; a < fargs.size(); ++a)
+      {
+      CompileArgument(body, fargs[a].Value, body.Templates[c][a]);
+      }
+    }
+}
+
+void cmMacroHelperCommand::CompileArgument(cmMacroBody const& body,
+                                           std::string const& value,
+                                           cmMacroArgumentTemplate& t)
+{
+  typedef cmMacroArgumentTemplate::Piece Piece;
+  std::string literal;
+  std::string::size_type pos = 0;
+  while(pos < value.size())
+    {
+    std::string::size_type ref = value.find("${", pos);
+    std::string::size_type close =
+      ref == value.npos? value.npos : value.find('}', ref);
+    if(close == value.npos)
+      {
+      literal += value.substr(pos);
+      break;
+      }
+    literal += value.substr(pos, ref-pos);
+    std::string name = value.substr(ref+2, close-ref-2);
+
+    // Look the name up in the order the references used to be
+    // replaced: formal parameters first, then ARGC, ARGN, ARGV, ARGVn.
+    Piece::Type type = Piece::Literal;
+    unsigned int index = 0;
+    for(unsigned int j = 1; j < body.Args.size(); ++j)
+      {
+      if(name == body.Args[j])
+        {
+        type = Piece::Formal;
+        index = j-1;
+        break;
+        }
+      }
+    if(type == Piece::Literal)
+      {
+      if(name == "ARGC")
+        {
+        type = Piece::ArgC;
+        }
+      else if(name == "ARGN")
+        {
+        type = Piece::ArgN;
+        }
+      else if(name == "ARGV")
+        {
+        type = Piece::ArgV;
+        }
+      else if(name.size() > 4 && name.substr(0, 4) == "ARGV" &&
+              name.find_first_not_of("0123456789", 4) == name.npos &&
+              (name[4] != '0' || name.size() == 5))
+        {
+        type = Piece::ArgVN;
+        index = static_cast<unsigned int>(atoi(name.c_str()+4));
+        }
+      }
+
+    if(type == Piece::Literal)
+      {
+      // Not a reference to a macro argument.  Keep the "$" and look
+      // for references inside the braces.
+      t.Nested = true;
+      literal += "$";
+      pos = ref+1;
+      continue;
+      }
+    if(!literal.empty())
+      {
+      t.Pieces.push_back(Piece(Piece::Literal, 0, literal));
+      literal = "";
+      }
+    t.Pieces.push_back(Piece(type, index, value.substr(ref, close-ref+1)));
+    t.HasReferences = true;
+    pos = close+1;
+    }
+  if(!literal.empty())
+    {
+    t.Pieces.push_back(Piece(Piece::Literal, 0, literal));
+    }
+}
+
+void cmMacroHelperCommand
+::ReplaceArguments(std::string& tmps,
+                   std::vector<std::string> const& expandedArgs,
+                   std::string const& argcDef,
+                   std::string& argnDef, bool& argnDefInitialized,
+                   std::string& argvDef, bool& argvDefInitialized)
+{
+  std::string variable;
+
+  // replace formal arguments
+  for (unsigned int j = 1; j < this->Body->Args.size(); ++j)
+    {
+    variable = "${";
+    variable += this->Body->Args[j];
+    variable += "}"; 
+    cmSystemTools::ReplaceString(tmps, variable.c_str(),
+                                 expandedArgs[j-1].c_str());
+    }
+  // replace argc
+  cmSystemTools::ReplaceString(tmps, "${ARGC}",argcDef.c_str());
+
+  // repleace ARGN
+  if (tmps.find("${ARGN}") != std::string::npos)
+    {
+    if (!argnDefInitialized)
+      {
+      cmMacroJoinArguments(expandedArgs, this->Body->Args.size()-1, argnDef);
+      argnDefInitialized = true;
+      }
+    cmSystemTools::ReplaceString(tmps, "${ARGN}", argnDef.c_str());
+    }
+
+  // if the current argument of the current function has ${ARGV in it
+  // then try replacing ARGV values
+  if (tmps.find("${ARGV") != std::string::npos)
+    {
+    char argvName[60];
+
+    // repleace ARGV, compute it only once
+    if (!argvDefInitialized)
+      {
+      cmMacroJoinArguments(expandedArgs, 0, argvDef);
+      argvDefInitialized = true;
+      }
+    cmSystemTools::ReplaceString(tmps, "${ARGV}", argvDef.c_str());
+
+    // also replace the ARGV1 ARGV2 ... etc
+    for (unsigned int t = 0; t < expandedArgs.size(); ++t)
+      {
+      sprintf(argvName,"${ARGV%i}",t);
+      cmSystemTools::ReplaceString(tmps, argvName,
+                                   expandedArgs[t].c_str());
+      }
+    }
+}
 
 bool cmMacroHelperCommand::InvokeInitialPass
 (const std::vector<cmListFileArgument>& args,
@@ -94,15 +321,14 @@ bool cmMacroHelperCommand::InvokeInitialPass
 
   std::string tmps;
   cmListFileArgument arg;
-  std::string variable;
 
   // make sure the number of arguments passed is at least the number
   // required by the signature
-  if (expandedArgs.size() < this->Args.size() - 1)
+  if (expandedArgs.size() < this->Body->Args.size() - 1)
     {
     std::string errorMsg =
       "Macro invoked with incorrect arguments for macro named: ";
-    errorMsg += this->Args[0];
+    errorMsg += this->Body->Args[0];
     this->SetError(errorMsg.c_str());
     return false;
     }
@@ -118,17 +344,30 @@ bool cmMacroHelperCommand::InvokeInitialPass
   bool argnDefInitialized = false;
   bool argvDefInitialized = false;
 
+  // The body templates can be filled in directly unless an argument
+  // value could itself form a reference once substituted.
+  bool fillTemplates = true;
+  for(std::vector<std::string>::const_iterator ei = expandedArgs.begin();
+      ei != expandedArgs.end(); ++ei)
+    {
+    if(ei->find_first_of("${}") != ei->npos)
+      {
+      fillTemplates = false;
+      break;
+      }
+    }
+
   // Invoke all the functions that were collected in the block.
   cmListFileFunction newLFF;
   // for each function
-  for(unsigned int c = 0; c < this->Functions.size(); ++c)
+  for(unsigned int c = 0; c < this->Body->Functions.size(); ++c)
     {
     // Replace the formal arguments and then invoke the command.
     newLFF.Arguments.clear();
-    newLFF.Arguments.reserve(this->Functions[c].Arguments.size());
-    newLFF.Name = this->Functions[c].Name;
-    newLFF.FilePath = this->Functions[c].FilePath;
-    newLFF.Line = this->Functions[c].Line;
+    newLFF.Arguments.reserve(this->Body->Functions[c].Arguments.size());
+    newLFF.Name = this->Body->Functions[c].Name;
+    newLFF.FilePath = this->Body->Functions[c].FilePath;
+    newLFF.Line = this->Body->Functions[c].Line;
     const char* def = this->Makefile->GetDefinition
       ("CMAKE_MACRO_REPORT_DEFINITION_LOCATION"); 
     bool macroReportLocation = false;
@@ -138,76 +377,65 @@ bool cmMacroHelperCommand::InvokeInitialPass
       }
 
     // for each argument of the current function
+    std::vector<cmMacroArgumentTemplate>::const_iterator ti =
+      this->Body->Templates[c].begin();
     for (std::vector<cmListFileArgument>::const_iterator k = 
-           this->Functions[c].Arguments.begin();
-         k != this->Functions[c].Arguments.end(); ++k)
+           this->Body->Functions[c].Arguments.begin();
+         k != this->Body->Functions[c].Arguments.end(); ++k, ++ti)
       {
-      tmps = k->Value;
-      // replace formal arguments
-      for (unsigned int j = 1; j < this->Args.size(); ++j)
+      if(!ti->HasReferences)
         {
-        variable = "${";
-        variable += this->Args[j];
-        variable += "}"; 
-        cmSystemTools::ReplaceString(tmps, variable.c_str(),
-                                     expandedArgs[j-1].c_str());
+        tmps = k->Value;
         }
-      // replace argc
-      cmSystemTools::ReplaceString(tmps, "${ARGC}",argcDef.c_str());
-
-      // repleace ARGN
-      if (tmps.find("${ARGN}") != std::string::npos)
+      else if(fillTemplates && !ti->Nested)
         {
-        if (!argnDefInitialized)
+        typedef cmMacroArgumentTemplate::Piece Piece;
+        tmps = "";
+        for(std::vector<Piece>::const_iterator pi = ti->Pieces.begin();
+            pi != ti->Pieces.end(); ++pi)
           {
-          std::vector<std::string>::const_iterator eit;
-          std::vector<std::string>::size_type cnt = 0;
-          for ( eit = expandedArgs.begin(); eit != expandedArgs.end(); ++eit )
+          switch(pi->PieceType)
             {
-            if ( cnt >= this->Args.size()-1 )
-              {
-              if ( argnDef.size() > 0 )
+            case Piece::Literal:
+              tmps += pi->Text;
+              break;
+            case Piece::Formal:
+              tmps += expandedArgs[pi->Index];
+              break;
+            case Piece::ArgC:
+              tmps += argcDef;
+              break;
+            case Piece::ArgN:
+              if (!argnDefInitialized)
                 {
-                argnDef += ";";
+                cmMacroJoinArguments(expandedArgs, this->Body->Args.size()-1,
+                                     argnDef);
+                argnDefInitialized = true;
                 }
-              argnDef += *eit;
-              }
-            cnt ++;
+              tmps += argnDef;
+              break;
+            case Piece::ArgV:
+              if (!argvDefInitialized)
+                {
+                cmMacroJoinArguments(expandedArgs, 0, argvDef);
+                argvDefInitialized = true;
+                }
+              tmps += argvDef;
+              break;
+            case Piece::ArgVN:
+              // References past the last argument are left alone.
+              tmps += pi->Index < expandedArgs.size()?
+                expandedArgs[pi->Index] : pi->Text;
+              break;
             }
-          argnDefInitialized = true;
           }
-        cmSystemTools::ReplaceString(tmps, "${ARGN}", argnDef.c_str());
         }
-
-      // if the current argument of the current function has ${ARGV in it
-      // then try replacing ARGV values
-      if (tmps.find("${ARGV") != std::string::npos)
+      else
         {
-        char argvName[60];
-
-        // repleace ARGV, compute it only once
-        if (!argvDefInitialized)
-          {
-          std::vector<std::string>::const_iterator eit;
-          for ( eit = expandedArgs.begin(); eit != expandedArgs.end(); ++eit )
-            {
-            if ( argvDef.size() > 0 )
-              {
-              argvDef += ";";
-              }
-            argvDef += *eit;
-            }
-          argvDefInitialized = true;
-          }
-        cmSystemTools::ReplaceString(tmps, "${ARGV}", argvDef.c_str());
-
-        // also replace the ARGV1 ARGV2 ... etc
-        for (unsigned int t = 0; t < expandedArgs.size(); ++t)
-          {
-          sprintf(argvName,"${ARGV%i}",t);
-          cmSystemTools::ReplaceString(tmps, argvName,
-                                       expandedArgs[t].c_str());
-          }
+        tmps = k->Value;
+        this->ReplaceArguments(tmps, expandedArgs, argcDef,
+                               argnDef, argnDefInitialized,
+                               argvDef, argvDefInitialized);
         }
 
       arg.Value = tmps;
@@ -236,8 +464,11 @@ bool cmMacroHelperCommand::InvokeInitialPass
         }
       newLFF.Arguments.push_back(arg);
       }
+    // The body command keeps its resolved prototype across calls.
+    cmCommand* proto = this->Makefile->GetCMakeInstance()
+      ->ResolveCommand(this->Body->Functions[c]);
     cmExecutionStatus status;
-    if(!this->Makefile->ExecuteCommand(newLFF, status) ||
+    if(!this->Makefile->ExecuteCommand(newLFF, proto, status) ||
        status.GetNestedError())
       {
       // The error message should have already included the call stack
@@ -284,9 +515,11 @@ IsFunctionBlocked(const cmListFileFunction& lff, cmMakefile &mf,
       name += " )";
       mf.AddMacro(this->Args[0].c_str(), name.c_str());
       // create a new command and add it to cmake
-      cmMacroHelperCommand *f = new cmMacroHelperCommand();
-      f->Args = this->Args;
-      f->Functions = this->Functions;
+      cmMacroBody* body = new cmMacroBody;
+      body->Args = this->Args;
+      body->Functions = this->Functions;
+      cmMacroHelperCommand::CompileBody(*body);
+      cmMacroHelperCommand *f = new cmMacroHelperCommand(body);
       std::string newName = "_" + this->Args[0];
       mf.GetCMakeInstance()->RenameCommand(this->Args[0].c_str(), 
                                            newName.c_str());
@@ -17,6 +17,7 @@
 #include "cmMakefile.h"
 #include "cmVersion.h"
 #include "cmCommand.h"
+#include "cmFindBase.h"
 #include "cmSourceFile.h"
 #include "cmSourceFileLocation.h"
 #include "cmSystemTools.h"
@@ -26,8 +27,11 @@
 #include "cmCacheManager.h"
 #include "cmFunctionBlocker.h"
 #include "cmListFileCache.h"
+#include "cmListFileProgram.h"
+#include "cmProfiler.h"
 #include "cmCommandArgumentParserHelper.h"
 #include "cmTest.h"
+#include "cmGeneratedFileStream.h"
 #ifdef CMAKE_BUILD_WITH_CMAKE
 #  include "cmVariableWatch.h"
 #endif
@@ -55,7 +59,7 @@ extern "C" {
 // default is not to be building executables
 cmMakefile::cmMakefile()
 {
-  this->DefinitionStack.push_back(DefinitionMap());
+  this->DefinitionStack.push_back(cmDefinitions());
 
   // Setup the default include file regular expression (match everything).
   this->IncludeFileRegularExpression = "^.*$";
@@ -135,7 +139,7 @@ cmMakefile::cmMakefile(const cmMakefile& mf)
   this->SourceGroups = mf.SourceGroups;
 #endif
 
-  this->DefinitionStack.push_back(mf.DefinitionStack.back());
+  this->DefinitionStack.push_back(mf.DefinitionStack.back().Closure());
   this->LocalGenerator = mf.LocalGenerator;
   this->FunctionBlockers = mf.FunctionBlockers;
   this->DataMap = mf.DataMap;
@@ -148,15 +152,129 @@ cmMakefile::cmMakefile(const cmMakefile& mf)
   this->Initialize();
 }
 
-//----------------------------------------------------------------------------550
+//----------------------------------------------------------------------------
+// The makefile whose Lua code is running, or the one that made the
+// proxy (upvalue 1) while no Lua code of a makefile runs.
+static cmMakefile* cmMakefileLuaCurrent(lua_State* L)
+{
+  cmMakefile* mf =
+    static_cast<cmMakefile*>(lua_touserdata(L, lua_upvalueindex(1)));
+  if(cmMakefile* current = mf->GetCMakeInstance()->GetCurrentLuaMakefile())
+    {
+    return current;
+    }
+  return mf;
+}
+
+//----------------------------------------------------------------------------
+// __index of cmake.vars: look the variable up when it is read.  A
+// CMake list comes back as a Lua array, anything else as a string.
+static int cmMakefileLuaVarsIndex(lua_State* L)
+{
+  cmMakefile* mf = cmMakefileLuaCurrent(L);
+  cmCommand::PushLuaValue(L, mf->GetDefinition(luaL_checkstring(L, 2)));
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// __newindex of cmake.vars: set the variable in the current scope.
+// Arrays are stored as CMake lists and nil removes the definition.
+static int cmMakefileLuaVarsNewIndex(lua_State* L)
+{
+  cmMakefile* mf = cmMakefileLuaCurrent(L);
+  const char* name = luaL_checkstring(L, 2);
+  switch(lua_type(L, 3))
+    {
+    case LUA_TNIL:
+      mf->RemoveDefinition(name);
+      break;
+    case LUA_TBOOLEAN:
+      mf->AddDefinition(name, lua_toboolean(L, 3)? "true" : "false");
+      break;
+    case LUA_TTABLE:
+      {
+      std::string value;
+      int n = luaL_getn(L, 3);
+      for(int i = 1; i <= n; ++i)
+        {
+        lua_rawgeti(L, 3, i);
+        size_t len = 0;
+        const char* item = lua_tolstring(L, -1, &len);
+        if(i > 1)
+          {
+          value += ";";
+          }
+        if(item)
+          {
+          value.append(item, len);
+          }
+        lua_pop(L, 1);
+        }
+      mf->AddDefinition(name, value.c_str());
+      }
+      break;
+    default:
+      {
+      const char* value = lua_tostring(L, 3);
+      if(!value)
+        {
+        return luaL_error(L, "cmake.vars.%s: cannot store a %s", name,
+                          luaL_typename(L, 3));
+        }
+      mf->AddDefinition(name, value);
+      }
+      break;
+    }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+void cmMakefile::PushLuaVars(lua_State* L)
+{
+  lua_newtable(L);
+  lua_createtable(L, 0, 2);
+  lua_pushlightuserdata(L, this);
+  lua_pushcclosure(L, cmMakefileLuaVarsIndex, 1);
+  lua_setfield(L, -2, "__index");
+  lua_pushlightuserdata(L, this);
+  lua_pushcclosure(L, cmMakefileLuaVarsNewIndex, 1);
+  lua_setfield(L, -2, "__newindex");
+  lua_setmetatable(L, -2);
+}
+
+//----------------------------------------------------------------------------
+lua_State* cmMakefile::GetLuaState() const
+{
+  return this->GetCMakeInstance()->GetLuaState();
+}
+
+//----------------------------------------------------------------------------
 void cmMakefile::InitializeLuaState()
 {
-  lua_State* L = this->GetCMakeInstance()->GetLuaState();
+  lua_State* L = this->GetLuaState();
   if (L) 
     {     
     registerMemberFunction(L, this, &cmMakefile::GetDefinition, "GetDefinition");
     registerMemberFunction(L, this, &cmMakefile::AddDefinition, "AddDefinition");
 
+    // tune the incremental collector; the Lua defaults are 200 and 200
+    if(const char* pause = this->GetDefinition("CMAKE_LUA_GC_PAUSE"))
+      {
+      lua_gc(L, LUA_GCSETPAUSE, atoi(pause));
+      }
+    if(const char* stepmul = this->GetDefinition("CMAKE_LUA_GC_STEPMUL"))
+      {
+      lua_gc(L, LUA_GCSETSTEPMUL, atoi(stepmul));
+      }
+
+    // cmake.vars is an empty proxy; all access goes to the metatable
+    lua_getglobal(L, "cmake");
+    this->PushLuaVars(L);
+    lua_setfield(L, -2, "vars");
+    lua_pushcfunction(L, cmFindBase::LuaFind);
+    lua_setfield(L, -2, "find");
+    lua_pop(L, 1);
+
     // Run utility helper
     int error = RunLuaFile(this->GetModulesFile("lua/LuaPublicAPIHelper.lua"));
     if(0 != error)
@@ -172,12 +290,12 @@ void cmMakefile::InitializeLuaState()
 int cmMakefile::RunLuaFile(const std::string& filename)
 {
   int error = 0;
-  lua_State* L = this->GetCMakeInstance()->GetLuaState();
+  lua_State* L = this->GetLuaState();
   if (!filename.empty())
     {
     //std::cerr << "Path to runLuaFile file is: " << filename << std::endl;
    
-    int error = luaL_loadfile(L, filename.c_str());
+    int error = this->LoadLuaFile(filename.c_str());
     if ( error==0 )
       {
       // execute Lua program
@@ -197,6 +315,80 @@ int cmMakefile::RunLuaFile(const std::string& filename)
   return error;
 }
 
+//----------------------------------------------------------------------------
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+static int cmMakefileLuaDumpWriter(lua_State*, const void* p, size_t sz,
+                                   void* ud)
+{
+  static_cast<std::string*>(ud)->append(static_cast<const char*>(p), sz);
+  return 0;
+}
+#endif
+
+//----------------------------------------------------------------------------
+int cmMakefile::LoadLuaFile(const char* filename)
+{
+  lua_State* L = this->GetLuaState();
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // The compiled chunk is cached in CMakeFiles/LuaCache.  The first
+  // line of a cache file names the Lua release and the source it was
+  // compiled from, so an edit or a different Lua rejects the entry.
+  // A file modified during this run is not cached, an edit within the
+  // same second would keep its time stamp.
+  std::string cacheFile;
+  std::string key;
+  cmake* cm = this->GetCMakeInstance();
+  long int mtime = cmSystemTools::ModifiedTime(filename);
+  if(!cm->GetScriptMode() &&
+     !cm->GetListFileCache()->IsRecentlyModified(mtime))
+    {
+    cacheFile = this->GetHomeOutputDirectory();
+    cacheFile += cmake::GetCMakeFilesDirectory();
+    cacheFile += "/LuaCache/";
+    cacheFile += cmSystemTools::ComputeStringMD5(filename);
+    cacheFile += ".luac";
+    cmOStringStream k;
+    k << LUA_RELEASE << " " << mtime << " "
+      << cmSystemTools::FileLength(filename) << " " << filename;
+    key = k.str();
+
+    std::ifstream fin(cacheFile.c_str(), std::ios::in | std::ios::binary);
+    std::string line;
+    if(fin && cmSystemTools::GetLineFromStream(fin, line) && line == key)
+      {
+      std::string chunk((std::istreambuf_iterator<char>(fin)),
+                        std::istreambuf_iterator<char>());
+      std::string chunkname = "@";
+      chunkname += filename;
+      if(luaL_loadbuffer(L, chunk.data(), chunk.size(),
+                         chunkname.c_str()) == 0)
+        {
+        return 0;
+        }
+      // a damaged cache file is just compiled again
+      lua_pop(L, 1);
+      }
+    }
+#endif
+
+  int error = luaL_loadfile(L, filename);
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  if(error == 0 && !cacheFile.empty())
+    {
+    std::string chunk;
+    lua_dump(L, cmMakefileLuaDumpWriter, &chunk);
+    cmSystemTools::MakeDirectory
+      (cmSystemTools::GetFilenamePath(cacheFile).c_str());
+    cmGeneratedFileStream fout;
+    fout.Open(cacheFile.c_str(), true, true);
+    fout << key << "\n";
+    fout.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    }
+#endif
+  return error;
+}
+
 //----------------------------------------------------------------------------
 void cmMakefile::Initialize()
 {
@@ -251,9 +443,22 @@ cmMakefile::~cmMakefile()
     {
     delete *i;
     }
-  for(unsigned int i=0; i < this->UsedCommands.size(); i++)
+  for(unsigned int i=0; i < this->FinalPassCommands.size(); i++)
+    {
+    delete this->FinalPassCommands[i];
+    }
+  for(unsigned int i=0; i < this->RetainedCommands.size(); i++)
     {
-    delete this->UsedCommands[i];
+    delete this->RetainedCommands[i];
+    }
+  for(CommandPoolType::iterator p = this->CommandPool.begin();
+      p != this->CommandPool.end(); ++p)
+    {
+    for(std::vector<cmCommand*>::iterator i = p->second.begin();
+        i != p->second.end(); ++i)
+      {
+      delete *i;
+      }
     }
   for(DataMapType::const_iterator d = this->DataMap.begin();
       d != this->DataMap.end(); ++d)
@@ -419,6 +624,16 @@ private:
 //----------------------------------------------------------------------------
 bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
                                 cmExecutionStatus &status)
+{
+  // Lookup the command prototype.
+  return this->ExecuteCommand
+    (lff, this->GetCMakeInstance()->ResolveCommand(lff), status);
+}
+
+//----------------------------------------------------------------------------
+bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
+                                cmCommand* proto,
+                                cmExecutionStatus &status)
 {
   bool result = true;
 
@@ -429,53 +644,22 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
     return result;
     }
   
-  std::string name = lff.Name;
-
   // Place this call on the call stack.
   cmMakefileCall stack_manager(this, lff, status);
   static_cast<void>(stack_manager);
 
-  // Lookup the command prototype.
-  if(cmCommand* proto = this->GetCMakeInstance()->GetCommand(name.c_str()))
+  if(proto)
     {
-    // Clone the prototype.
-    cmsys::auto_ptr<cmCommand> pcmd(proto->Clone());
-    pcmd->SetMakefile(this);
-
-    // Decide whether to invoke the command.
-    if(pcmd->GetEnabled() && !cmSystemTools::GetFatalErrorOccured()  &&
-       (!this->GetCMakeInstance()->GetScriptMode() || pcmd->IsScriptable()))
+    cmProfiler* profiler = this->GetCMakeInstance()->GetProfiler();
+    if(profiler)
       {
-      // Try invoking the command.
-      if(!pcmd->InvokeInitialPass(lff.Arguments,status) ||
-         status.GetNestedError())
-        {
-        if(!status.GetNestedError())
-          {
-          // The command invocation requested that we report an error.
-          this->IssueMessage(cmake::FATAL_ERROR, pcmd->GetError());
-          }
-        result = false;
-        if ( this->GetCMakeInstance()->GetScriptMode() )
-          {
-          cmSystemTools::SetFatalErrorOccured();
-          }
-        }
-      else
-        {
-        // use the command
-        this->UsedCommands.push_back(pcmd.release());
-        }
+      profiler->Start("command", lff.Name.c_str(),
+                      lff.FilePath.c_str(), lff.Line);
       }
-    else if ( this->GetCMakeInstance()->GetScriptMode()
-              && !pcmd->IsScriptable() )
+    result = this->InvokeCommand(proto, &lff.Arguments, 0, status);
+    if(profiler)
       {
-      std::string error = "Command ";
-      error += pcmd->GetName();
-      error += "() is not scriptable";
-      this->IssueMessage(cmake::FATAL_ERROR, error);
-      result = false;
-      cmSystemTools::SetFatalErrorOccured();
+      profiler->Stop();
       }
     }
   else
@@ -494,6 +678,151 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
   return result;
 }
 
+//----------------------------------------------------------------------------
+bool cmMakefile::ExecuteCommand(const cmListFileContext& lfc,
+                                std::vector<std::string> const& args,
+                                cmExecutionStatus &status)
+{
+  cmCommand* proto = this->GetCMakeInstance()->GetCommand(lfc.Name.c_str());
+
+  // Function blockers and commands that look at their raw arguments
+  // need a real listfile function.  The arguments are already split
+  // and expanded, so pass them quoted and literal to give the command
+  // the same values as the direct path below.
+  if(!proto || !this->FunctionBlockers.empty() ||
+     !proto->AcceptsDirectArguments())
+    {
+    this->GetCMakeInstance()->RecordLuaCommandCall(false);
+    cmListFileFunction lff;
+    lff.Name = lfc.Name;
+    lff.FilePath = lfc.FilePath;
+    lff.Line = lfc.Line;
+    lff.Arguments.reserve(args.size());
+    for(std::vector<std::string>::const_iterator i = args.begin();
+        i != args.end(); ++i)
+      {
+      lff.Arguments.push_back(cmListFileArgument(*i, true,
+                                                 lff.FilePath.c_str(),
+                                                 lff.Line));
+      lff.Arguments.back().SetLiteral();
+      }
+    return this->ExecuteCommand(lff, status);
+    }
+  this->GetCMakeInstance()->RecordLuaCommandCall(true);
+
+  // Place this call on the call stack.
+  cmMakefileCall stack_manager(this, lfc, status);
+  static_cast<void>(stack_manager);
+
+  cmProfiler* profiler = this->GetCMakeInstance()->GetProfiler();
+  if(profiler)
+    {
+    profiler->Start("command", lfc.Name.c_str(),
+                    lfc.FilePath.c_str(), lfc.Line);
+    }
+  bool result = this->InvokeCommand(proto, 0, &args, status);
+  if(profiler)
+    {
+    profiler->Stop();
+    }
+  return result;
+}
+
+//----------------------------------------------------------------------------
+bool cmMakefile::InvokeCommand(cmCommand* proto,
+                               std::vector<cmListFileArgument> const* lfArgs,
+                               std::vector<std::string> const* args,
+                               cmExecutionStatus &status)
+{
+  bool result = true;
+
+  // Get an instance of the prototype.
+  cmCommand* pcmd = this->GetCommandInstance(proto);
+  pcmd->SetMakefile(this);
+
+  // Decide whether to invoke the command.
+  if(pcmd->GetEnabled() && !cmSystemTools::GetFatalErrorOccured()  &&
+     (!this->GetCMakeInstance()->GetScriptMode() || pcmd->IsScriptable()))
+    {
+    // Try invoking the command.  Arguments from the Lua bindings are
+    // already expanded and go straight to the initial pass.
+    bool invoked = lfArgs? pcmd->InvokeInitialPass(*lfArgs,status) :
+                           pcmd->InitialPass(*args,status);
+    if(!invoked || status.GetNestedError())
+      {
+      if(!status.GetNestedError())
+        {
+        // The command invocation requested that we report an error.
+        this->IssueMessage(cmake::FATAL_ERROR, pcmd->GetError());
+        }
+      result = false;
+      if ( this->GetCMakeInstance()->GetScriptMode() )
+        {
+        cmSystemTools::SetFatalErrorOccured();
+        }
+      }
+    else if(pcmd->HasFinalPass())
+      {
+      // Keep the command instance for the final pass.
+      this->FinalPassCommands.push_back(pcmd);
+      pcmd = 0;
+      }
+    else if(pcmd->IsUsedAfterInitialPass())
+      {
+      // Keep the command instance for those who refer to it.
+      this->RetainedCommands.push_back(pcmd);
+      pcmd = 0;
+      }
+    }
+  else if ( this->GetCMakeInstance()->GetScriptMode()
+            && !pcmd->IsScriptable() )
+    {
+    std::string error = "Command ";
+    error += pcmd->GetName();
+    error += "() is not scriptable";
+    this->IssueMessage(cmake::FATAL_ERROR, error);
+    result = false;
+    cmSystemTools::SetFatalErrorOccured();
+    }
+
+  if(pcmd)
+    {
+    this->ReleaseCommandInstance(pcmd);
+    }
+  return result;
+}
+
+//----------------------------------------------------------------------------
+cmCommand* cmMakefile::GetCommandInstance(cmCommand* proto)
+{
+  if(proto->IsReusable())
+    {
+    std::vector<cmCommand*>& pool =
+      this->CommandPool[proto->GetNameOfClass()];
+    if(!pool.empty())
+      {
+      cmCommand* instance = pool.back();
+      pool.pop_back();
+      return instance;
+      }
+    }
+  return proto->Clone();
+}
+
+//----------------------------------------------------------------------------
+void cmMakefile::ReleaseCommandInstance(cmCommand* instance)
+{
+  if(instance->IsReusable())
+    {
+    instance->Reset();
+    this->CommandPool[instance->GetNameOfClass()].push_back(instance);
+    }
+  else
+    {
+    delete instance;
+    }
+}
+
 // Parse the given CMakeLists.txt file executing all commands
 //
 bool cmMakefile::ReadListFile(const char* filename_in,
@@ -588,27 +917,24 @@ bool cmMakefile::ReadListFile(const char* filename_in,
   // is it a lua file ?
   if (cmSystemTools::GetFilenameLastExtension(filenametoread) == ".lua")
     {
-    lua_State *L = this->GetCMakeInstance()->GetLuaState();
+    lua_State *L = this->GetLuaState();
     this->ListFiles.push_back(filenametoread);
 
-    // get the current makefile setting
-    lua_pushstring(L,"cmCurrentMakefile");
-    lua_gettable(L, LUA_REGISTRYINDEX);
-    cmMakefile *previousMF = 
-      static_cast<cmMakefile *>(lua_touserdata(L,-1));
+    // cmake.* calls act on this makefile while the file runs
+    cmMakefile *previousMF =
+      this->GetCMakeInstance()->SetCurrentLuaMakefile(L, this);
 
-    // make sure the current Makefile is set
-    lua_pushstring(L,"cmCurrentMakefile");
-    lua_pushlightuserdata(L, this);
-    lua_settable(L, LUA_REGISTRYINDEX);
-
-    // load and run the lua
-    int result = luaL_dofile(L, filenametoread);
+    // load and run the lua; it runs in _G, so globals are plain
+    // table reads and the cmake.* calls find this makefile through
+    // the cmake instance
+    int result = this->LoadLuaFile(filenametoread);
+    if (!result)
+      {
+      result = lua_pcall(L, 0, LUA_MULTRET, 0);
+      }
 
     // restore the prior makefile setting
-    lua_pushstring(L,"cmCurrentMakefile");
-    lua_pushlightuserdata(L, previousMF);
-    lua_settable(L, LUA_REGISTRYINDEX);
+    this->GetCMakeInstance()->SetCurrentLuaMakefile(L, previousMF);
 
     if (result)
       {
@@ -629,8 +955,21 @@ bool cmMakefile::ReadListFile(const char* filename_in,
     }
   else
     {
-    cmListFile cacheFile;
-    if( !cacheFile.ParseFile(filenametoread, requireProjectCommand, this) )
+    // Included files come from the cache for this run.  The top-level
+    // CMakeLists.txt may get an implicit project() call, so it is
+    // always parsed.
+    cmListFile localFile;
+    cmListFile const* listFile = 0;
+    if(!requireProjectCommand && this->GetCMakeInstance())
+      {
+      listFile = this->GetCMakeInstance()->GetListFileCache()
+        ->GetListFile(filenametoread, this, localFile);
+      }
+    else if(localFile.ParseFile(filenametoread, requireProjectCommand, this))
+      {
+      listFile = &localFile;
+      }
+    if( !listFile )
       {
       // pop the listfile off the stack
       this->ListFileStack.pop_back();
@@ -644,17 +983,35 @@ bool cmMakefile::ReadListFile(const char* filename_in,
       }
     // add this list file to the list of dependencies
     this->ListFiles.push_back( filenametoread);
-    const size_t numberFunctions = cacheFile.Functions.size();
-    for(size_t i =0; i < numberFunctions; ++i)
+    cmListFileProgram const* program = 0;
+    if(this->IsOn("CMAKE_COMPILE_LISTFILES"))
+      {
+      program = listFile->GetProgram();
+      }
+    if(program)
       {
       cmExecutionStatus status;
-      this->ExecuteCommand(cacheFile.Functions[i],status);
+      program->Execute(*this, status, false);
       if (status.GetReturnInvoked() ||
         cmSystemTools::GetFatalErrorOccured() )
         {
-        // Exit early from processing this file.
         endScopeNicely = false;
-        break;
+        }
+      }
+    else
+      {
+      const size_t numberFunctions = listFile->Functions.size();
+      for(size_t i =0; i < numberFunctions; ++i)
+        {
+        cmExecutionStatus status;
+        this->ExecuteCommand(listFile->Functions[i],status);
+        if (status.GetReturnInvoked() ||
+          cmSystemTools::GetFatalErrorOccured() )
+          {
+          // Exit early from processing this file.
+          endScopeNicely = false;
+          break;
+          }
         }
       }
     }
@@ -776,8 +1133,8 @@ void cmMakefile::FinalPass()
 
   // give all the commands a chance to do something
   // after the file has been parsed before generation
-  for(std::vector<cmCommand*>::iterator i = this->UsedCommands.begin();
-      i != this->UsedCommands.end(); ++i)
+  for(std::vector<cmCommand*>::iterator i = this->FinalPassCommands.begin();
+      i != this->FinalPassCommands.end(); ++i)
     {
     (*i)->FinalPass();
     }
@@ -1388,7 +1745,7 @@ void cmMakefile::InitializeFromParent()
   cmMakefile *parent = this->LocalGenerator->GetParent()->GetMakefile();
 
   // copy the definitions
-  this->DefinitionStack.front() = parent->DefinitionStack.back();
+  this->DefinitionStack.front() = parent->DefinitionStack.back().Closure();
 
   // copy include paths
   this->IncludeDirectories = parent->IncludeDirectories;
@@ -1595,7 +1952,7 @@ void cmMakefile::AddDefinition(const char* name, const char* value)
 #endif
 
   this->TemporaryDefinitionKey = name;
-  this->DefinitionStack.back()[this->TemporaryDefinitionKey] = value;
+  this->DefinitionStack.back().Set(name, value);
 
 #ifdef CMAKE_BUILD_WITH_CMAKE
   cmVariableWatch* vv = this->GetVariableWatch();
@@ -1609,6 +1966,44 @@ void cmMakefile::AddDefinition(const char* name, const char* value)
 #endif
 }
 
+//----------------------------------------------------------------------------
+void cmMakefile::AppendDefinition(const char* name,
+                                  std::vector<std::string> const& elements)
+{
+  if(elements.empty())
+    {
+    return;
+    }
+
+  // Read the old value as list(APPEND) always did.  A value from the
+  // cache becomes the start of a normal variable.
+  std::string key = name;
+  const char* def = this->GetDefinition(key.c_str());
+  cmDefinitions& defs = this->DefinitionStack.back();
+  if(def && !defs.Get(key.c_str()))
+    {
+    std::string value = def;
+    defs.Set(key.c_str(), value.c_str());
+    }
+
+  for(std::vector<std::string>::const_iterator i = elements.begin();
+      i != elements.end(); ++i)
+    {
+    defs.Append(key.c_str(), i->c_str());
+    }
+
+#ifdef CMAKE_BUILD_WITH_CMAKE
+  cmVariableWatch* vv = this->GetVariableWatch();
+  if ( vv )
+    {
+    vv->VariableAccessed(key,
+                         cmVariableWatch::VARIABLE_MODIFIED_ACCESS,
+                         defs.Get(key.c_str()),
+                         this);
+    }
+#endif
+}
+
 
 void cmMakefile::AddCacheDefinition(const char* name, const char* value,
                                     const char* doc,
@@ -1644,26 +2039,13 @@ void cmMakefile::AddCacheDefinition(const char* name, const char* value,
     }
   this->GetCacheManager()->AddCacheEntry(name, val, doc, type);
   // if there was a definition then remove it
-  this->DefinitionStack.back().erase( DefinitionMap::key_type(name));
+  this->DefinitionStack.back().Set(name, 0);
 }
 
 
 void cmMakefile::AddDefinition(const char* name, bool value)
 {
-  if(value)
-    {
-    this->DefinitionStack.back()
-      .erase( DefinitionMap::key_type(name));
-    this->DefinitionStack.back()
-      .insert(DefinitionMap::value_type(name, "ON"));
-    }
-  else
-    {
-    this->DefinitionStack.back()
-      .erase( DefinitionMap::key_type(name));
-    this->DefinitionStack.back()
-      .insert(DefinitionMap::value_type(name, "OFF"));
-    }
+  this->DefinitionStack.back().Set(name, value? "ON" : "OFF");
 #ifdef CMAKE_BUILD_WITH_CMAKE
   cmVariableWatch* vv = this->GetVariableWatch();
   if ( vv )
@@ -1693,7 +2075,7 @@ void cmMakefile::AddCacheDefinition(const char* name,
 
 void cmMakefile::RemoveDefinition(const char* name)
 {
-  this->DefinitionStack.back().erase(DefinitionMap::key_type(name));
+  this->DefinitionStack.back().Set(name, 0);
 #ifdef CMAKE_BUILD_WITH_CMAKE
   cmVariableWatch* vv = this->GetVariableWatch();
   if ( vv )
@@ -2015,14 +2397,8 @@ const char* cmMakefile::GetRequiredDefinition(const char* name) const
 
 bool cmMakefile::IsDefinitionSet(const char* name) const
 {
-  const char* def = 0;
-  DefinitionMap::const_iterator pos = 
-    this->DefinitionStack.back().find(name);
-  if(pos != this->DefinitionStack.back().end())
-    {
-    def = (*pos).second.c_str();
-    }
-  else
+  const char* def = this->DefinitionStack.back().Get(name);
+  if(!def)
     {
     def = this->GetCacheManager()->GetCacheValue(name);
     }
@@ -2049,14 +2425,8 @@ const char* cmMakefile::GetDefinition(const char* name) const
       RecordPropertyAccess(name,cmProperty::VARIABLE);
     }
 #endif
-  const char* def = 0;
-  DefinitionMap::const_iterator pos = 
-    this->DefinitionStack.back().find(name);
-  if(pos != this->DefinitionStack.back().end())
-    {
-    def = (*pos).second.c_str();
-    }
-  else
+  const char* def = this->DefinitionStack.back().Get(name);
+  if(!def)
     {
     def = this->GetCacheManager()->GetCacheValue(name);
     }
@@ -2069,14 +2439,13 @@ const char* cmMakefile::GetDefinition(const char* name) const
       vv->VariableAccessed(name, cmVariableWatch::VARIABLE_READ_ACCESS,
         def, this);
       }
-    else
+    else if(vv->IsWatched(name))
       {
+      // Only a watched variable needs the unknown access probe.
       // are unknown access allowed
-      DefinitionMap::const_iterator pos2 =
-        this->DefinitionStack.back()
-        .find("CMAKE_ALLOW_UNKNOWN_VARIABLE_READ_ACCESS");
-      if (pos2 != this->DefinitionStack.back().end() &&
-          cmSystemTools::IsOn((*pos2).second.c_str()))
+      const char* allow = this->DefinitionStack.back()
+        .Get("CMAKE_ALLOW_UNKNOWN_VARIABLE_READ_ACCESS");
+      if(cmSystemTools::IsOn(allow))
         {
         vv->VariableAccessed(name,
           cmVariableWatch::ALLOWED_UNKNOWN_VARIABLE_READ_ACCESS, def, this);
@@ -2092,6 +2461,26 @@ const char* cmMakefile::GetDefinition(const char* name) const
   return def;
 }
 
+//----------------------------------------------------------------------------
+std::vector<std::string> const*
+cmMakefile::GetDefinitionList(const char* name,
+                              std::vector<std::string>& buffer) const
+{
+  const char* def = this->GetDefinition(name);
+  if(!def)
+    {
+    return 0;
+    }
+  if(std::vector<std::string> const* list =
+     this->DefinitionStack.back().GetList(name))
+    {
+    return list;
+    }
+  buffer.clear();
+  cmSystemTools::ExpandListArgument(def, buffer);
+  return &buffer;
+}
+
 const char* cmMakefile::GetSafeDefinition(const char* def) const
 {
   const char* ret = this->GetDefinition(def);
@@ -2108,11 +2497,11 @@ std::vector<std::string> cmMakefile
   std::map<cmStdString, int> definitions;
   if ( !cacheonly )
     {
-    DefinitionMap::const_iterator it;
-    for ( it = this->DefinitionStack.back().begin();
-          it != this->DefinitionStack.back().end(); it ++ )
+    std::set<cmStdString> keys = this->DefinitionStack.back().ClosureKeys();
+    for(std::set<cmStdString>::const_iterator it = keys.begin();
+        it != keys.end(); ++it)
       {
-      definitions[it->first] = 1;
+      definitions[*it] = 1;
       }
     }
   cmCacheManager::CacheIterator cit =
@@ -2392,11 +2781,19 @@ void cmMakefile::ExpandArguments(
   outArgs.reserve(inArgs.size());
   for(i = inArgs.begin(); i != inArgs.end(); ++i)
     {
-    // Expand the variables in the argument.
-    value = i->Value;
-    this->ExpandVariablesInString(value, false, false, false,
-                                  i->FilePath, i->Line,
-                                  false, true);
+    // Expand the variables in the argument.  Use the pre-parsed form
+    // when there is one so that loop bodies are not lexed each time.
+    if(i->CompileTemplate())
+      {
+      this->ExpandArgumentTemplate(*i, value);
+      }
+    else
+      {
+      value = i->Value;
+      this->ExpandVariablesInString(value, false, false, false,
+                                    i->FilePath, i->Line,
+                                    false, true);
+      }
 
     // If the argument is quoted, it should be one argument.
     // Otherwise, it may be a list of arguments.
@@ -2411,6 +2808,48 @@ void cmMakefile::ExpandArguments(
     }
 }
 
+void cmMakefile::ExpandArgumentTemplate(cmListFileArgument const& arg,
+                                        std::string& value) const
+{
+  // This must give the same result as ExpandVariablesInString called
+  // as in ExpandArguments.
+  value = "";
+  for(std::vector<cmListFileArgument::Segment>::const_iterator
+        si = arg.Template.begin(); si != arg.Template.end(); ++si)
+    {
+    const char* text = si->Text.c_str();
+    switch(si->SegmentType)
+      {
+      case cmListFileArgument::Segment::Literal:
+        value += si->Text;
+        break;
+      case cmListFileArgument::Segment::Environment:
+        if(const char* env = getenv(text))
+          {
+          value += env;
+          }
+        break;
+      case cmListFileArgument::Segment::Variable:
+        if(arg.FilePath && strcmp(text, "CMAKE_CURRENT_LIST_FILE") == 0)
+          {
+          value += arg.FilePath;
+          }
+        else if(arg.Line >= 0 &&
+                strcmp(text, "CMAKE_CURRENT_LIST_LINE") == 0)
+          {
+          cmOStringStream ostr;
+          ostr << arg.Line;
+          value += ostr.str();
+          }
+        else if(const char* def = this->GetDefinition(text))
+          {
+          value += def;
+          }
+        break;
+      }
+    }
+}
+
 void cmMakefile::RemoveFunctionBlocker(const cmListFileFunction& lff)
 {
   // loop over all function blockers to see if any block this command
@@ -2563,7 +3002,8 @@ void cmMakefile::ExpandSourceListArguments(
 int cmMakefile::TryCompile(const char *srcdir, const char *bindir,
                            const char *projectName, const char *targetName,
                            const std::vector<std::string> *cmakeArgs,
-                           std::string *output)
+                           std::string *output,
+                           const char* buildOptions)
 {
   // does the binary directory exist ? If not create it...
   if (!cmSystemTools::FileIsDirectory(bindir))
@@ -2594,6 +3034,11 @@ int cmMakefile::TryCompile(const char *srcdir, const char *bindir,
     }
   cm.SetGlobalGenerator(gg);
 
+  // Time the steps of the project and the commands of its listfiles
+  // as part of this run.
+  cmProfiler* profiler = this->GetCMakeInstance()->GetProfiler();
+  cm.SetProfiler(profiler);
+
   // do a configure
   cm.SetHomeDirectory(srcdir);
   cm.SetHomeOutputDirectory(bindir);
@@ -2619,7 +3064,16 @@ int cmMakefile::TryCompile(const char *srcdir, const char *bindir,
     cm.AddCacheEntry("CMAKE_SUPPRESS_DEVELOPER_WARNINGS",
                      "FALSE", "", cmCacheManager::INTERNAL);
     }    
-  if (cm.Configure() != 0)
+  if(profiler)
+    {
+    profiler->Start("try_compile", "try_compile configure", bindir, 0);
+    }
+  int configured = cm.Configure();
+  if(profiler)
+    {
+    profiler->Stop();
+    }
+  if (configured != 0)
     {
     cmSystemTools::Error(
       "Internal CMake error, TryCompile configure of cmake failed");
@@ -2628,7 +3082,16 @@ int cmMakefile::TryCompile(const char *srcdir, const char *bindir,
     return 1;
     }
 
-  if (cm.Generate() != 0)
+  if(profiler)
+    {
+    profiler->Start("try_compile", "try_compile generate", bindir, 0);
+    }
+  int generated = cm.Generate();
+  if(profiler)
+    {
+    profiler->Stop();
+    }
+  if (generated != 0)
     {
     cmSystemTools::Error(
       "Internal CMake error, TryCompile generation of cmake failed");
@@ -2638,12 +3101,21 @@ int cmMakefile::TryCompile(const char *srcdir, const char *bindir,
     }
 
   // finally call the generator to actually build the resulting project
+  if(profiler)
+    {
+    profiler->Start("try_compile", "try_compile build", bindir, 0);
+    }
   int ret =
     this->LocalGenerator->GetGlobalGenerator()->TryCompile(srcdir,bindir,
                                                            projectName,
                                                            targetName,
                                                            output,
-                                                           this);
+                                                           this,
+                                                           buildOptions);
+  if(profiler)
+    {
+    profiler->Stop();
+    }
 
   cmSystemTools::ChangeDirectory(cwd.c_str());
   return ret;
@@ -3222,14 +3694,10 @@ std::string cmMakefile::GetListFileStack()
 
 void cmMakefile::PushScope()
 {
-  // Get the index of the next stack entry.
-  std::vector<DefinitionMap>::size_type index = this->DefinitionStack.size();
-
-  // Allocate a new stack entry.
-  this->DefinitionStack.push_back(DefinitionMap());
-
-  // Copy the previous top to the new top.
-  this->DefinitionStack[index] = this->DefinitionStack[index-1];
+  // The new scope starts empty and looks variables up in the one
+  // below it, so pushing does not depend on the number of variables.
+  cmDefinitions* parent = &this->DefinitionStack.back();
+  this->DefinitionStack.push_back(cmDefinitions(parent));
 }
 
 void cmMakefile::PopScope()
@@ -3245,16 +3713,13 @@ void cmMakefile::RaiseScope(const char *var, const char *varDef)
     }
 
   // multiple scopes in this directory?
-  if (this->DefinitionStack.size() > 1)
+  cmDefinitions& cur = this->DefinitionStack.back();
+  if(cmDefinitions* up = cur.GetParent())
     {
-    if(varDef)
-      {
-      this->DefinitionStack[this->DefinitionStack.size()-2][var] = varDef;
-      }
-    else
-      {
-      this->DefinitionStack[this->DefinitionStack.size()-2].erase(var);
-      }
+    // First localize the definition in the current scope so that it
+    // keeps its value here, then update the parent scope.
+    cur.Get(var);
+    up->Set(var, varDef);
     }
   // otherwise do the parent (if one exists)
   else if (this->LocalGenerator->GetParent())
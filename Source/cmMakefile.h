@@ -19,6 +19,7 @@
 
 #include "cmCacheManager.h"
 #include "cmData.h"
+#include "cmDefinitions.h"
 #include "cmExecutionStatus.h"
 #include "cmListFileCache.h"
 #include "cmPolicies.h"
@@ -43,6 +44,7 @@ class cmTest;
 class cmVariableWatch;
 class cmake;
 class cmMakefileCall;
+struct lua_State;
 
 /** \class cmMakefile
  * \brief Process the input CMakeLists.txt file.
@@ -83,10 +85,29 @@ public:
   */
   void InitializeLuaState();
 
+  /**
+   * The Lua state listfiles of this directory run in, the one of the
+   * cmake instance.
+   */
+  lua_State* GetLuaState() const;
+
   /*
   */
   int RunLuaFile(const std::string& filename);
 
+  /**
+   * Load a Lua file as a chunk on top of the Lua stack, or its error
+   * message, like luaL_loadfile.  Compiled chunks are cached in the
+   * build tree so unchanged files skip the Lua parser.
+   */
+  int LoadLuaFile(const char* filename);
+
+  /**
+   * Push a cmake.vars proxy table.  It resolves against the makefile
+   * whose Lua code runs when it is used.
+   */
+  void PushLuaVars(lua_State* L);
+
   /**
    * Read and parse a CMakeLists.txt file.
    */
@@ -117,12 +138,14 @@ public:
   
   /**
    * Try running cmake and building a file. This is used for dynalically
-   * loaded commands, not as part of the usual build process.
+   * loaded commands, not as part of the usual build process.  The
+   * buildOptions are passed to the build tool.
    */
   int TryCompile(const char *srcdir, const char *bindir, 
                  const char *projectName, const char *targetName,
                  const std::vector<std::string> *cmakeArgs,
-                 std::string *output);
+                 std::string *output,
+                 const char* buildOptions = 0);
     
   /**
    * Specify the makefile generator. This is platform/compiler
@@ -288,6 +311,14 @@ public:
                           const char* doc,
                           cmCacheManager::CacheEntryType type);
 
+  /**
+   * Append elements to the list in a variable the way list(APPEND)
+   * does.  A variable of this makefile is extended in place, so
+   * building a list costs amortized constant time per element.
+   */
+  void AppendDefinition(const char* name,
+                        std::vector<std::string> const& elements);
+
   /**
    * Add bool variable definition to the build. 
    */
@@ -559,6 +590,16 @@ public:
   const char* GetSafeDefinition(const char*) const;
   const char* GetRequiredDefinition(const char* name) const;
   bool IsDefinitionSet(const char*) const;
+
+  /**
+   * Given a variable name, return its value split into list elements,
+   * or null if it is not defined.  The split of a variable of this
+   * makefile is kept with its value, so repeated queries are cheap.
+   * Values from the cache are split into the given buffer.
+   */
+  std::vector<std::string> const*
+  GetDefinitionList(const char* name,
+                    std::vector<std::string>& buffer) const;
   /**
    * Get the list of all variables in the current space. If argument
    * cacheonly is specified and is greater than 0, then only cache
@@ -584,10 +625,10 @@ public:
   bool CanIWriteThisFile(const char* fileName);
   
   /**
-   * Get the vector of used command instances.
+   * Get the vector of command instances that have a final pass.
    */
-  const std::vector<cmCommand*>& GetUsedCommands() const
-    {return this->UsedCommands;}
+  const std::vector<cmCommand*>& GetFinalPassCommands() const
+    {return this->FinalPassCommands;}
   
 #if defined(CMAKE_BUILD_WITH_CMAKE)
   /**
@@ -689,6 +730,22 @@ public:
   bool ExecuteCommand(const cmListFileFunction& lff, 
                       cmExecutionStatus &status);
 
+  /**
+   * Execute a single CMake command whose prototype the caller has
+   * already looked up, or null if there is no such command.
+   */
+  bool ExecuteCommand(const cmListFileFunction& lff, cmCommand* proto,
+                      cmExecutionStatus &status);
+
+  /**
+   * Execute a single CMake command with arguments that are already
+   * split and expanded, as they come from a Lua table.  Falls back to
+   * the listfile path when the command needs its raw arguments.
+   */
+  bool ExecuteCommand(const cmListFileContext& lfc,
+                      std::vector<std::string> const& args,
+                      cmExecutionStatus &status);
+
   /** Check if a command exists. */
   bool CommandExists(const char* name) const;
     
@@ -779,7 +836,6 @@ public:
   // Get the properties
   cmPropertyMap &GetProperties() { return this->Properties; };
 
-  typedef std::map<cmStdString, cmStdString> DefinitionMap;
   ///! Initialize a makefile from its parent
   void InitializeFromParent();
   
@@ -855,8 +911,11 @@ protected:
   std::vector<cmSourceGroup> SourceGroups;
 #endif
 
-  std::vector<DefinitionMap> DefinitionStack;
-  std::vector<cmCommand*> UsedCommands;
+  // Variable scopes; each one refers to the one below it.
+  std::list<cmDefinitions> DefinitionStack;
+  std::vector<cmCommand*> FinalPassCommands;
+  // Instances used after their initial pass, kept until destruction.
+  std::vector<cmCommand*> RetainedCommands;
   cmLocalGenerator* LocalGenerator;
   bool IsFunctionBlocked(const cmListFileFunction& lff, 
                          cmExecutionStatus &status);
@@ -864,8 +923,25 @@ protected:
 private:
   void Initialize();
 
+  bool InvokeCommand(cmCommand* proto,
+                     std::vector<cmListFileArgument> const* lfArgs,
+                     std::vector<std::string> const* args,
+                     cmExecutionStatus &status);
+
+  // Instances of reusable commands that are not running, by class
+  // name.  They do not refer to their prototype, which a command may
+  // remove while another one runs.
+  typedef std::map<const char*, std::vector<cmCommand*> > CommandPoolType;
+  CommandPoolType CommandPool;
+  cmCommand* GetCommandInstance(cmCommand* proto);
+  void ReleaseCommandInstance(cmCommand* instance);
+
   bool ParseDefineFlag(std::string const& definition, bool remove);
 
+  // Expand an argument from its pre-parsed template.
+  void ExpandArgumentTemplate(cmListFileArgument const& arg,
+                              std::string& value) const;
+
   void ReadSources(std::ifstream& fin, bool t);
   friend class cmMakeDepend;    // make depend needs direct access
                                 // to the Sources array 
@@ -885,7 +961,7 @@ private:
 
   std::map<cmStdString, bool> SubDirectoryOrder;
   // used in AddDefinition for performance improvement
-  DefinitionMap::key_type  TemporaryDefinitionKey;
+  cmStdString TemporaryDefinitionKey;
 
   cmsys::RegularExpression cmDefineRegex;
   cmsys::RegularExpression cmDefine01Regex;
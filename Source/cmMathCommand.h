@@ -34,6 +34,11 @@ public:
     return new cmMathCommand;
     }
 
+  /**
+   * This determines if one instance may run many invocations.
+   */
+  virtual bool IsReusable() { return true; }
+
   /**
    * This is called when the command is first encountered in
    * the CMakeLists.txt file.
@@ -41,6 +46,15 @@ public:
   virtual bool InitialPass(std::vector<std::string> const& args,
                            cmExecutionStatus &status);
 
+  /**
+   * The result variable follows the EXPR keyword.
+   */
+  virtual std::string
+  GetLuaResultVariable(std::vector<std::string> const& args)
+    {
+    return args.size() < 2? std::string() : args[1];
+    }
+
   /**
    * This determines if the command is invoked when in script mode.
    */
@@ -0,0 +1,296 @@
+/*=========================================================================
+
+  Program:   CMake - Cross-Platform Makefile Generator
+  Module:    $RCSfile: cmProfiler.cxx,v $
+  Language:  C++
+  Date:      $Date: 2008/06/05 16:40:12 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) 2002 Kitware, Inc., Insight Consortium.  All rights reserved.
+  See Copyright.txt or http://www.cmake.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "cmProfiler.h"
+
+#include "cmSystemTools.h"
+#include "cmGeneratedFileStream.h"
+#include "cmRegularExpressionCache.h"
+
+#include <algorithm>
+
+//----------------------------------------------------------------------------
+cmProfiler::cmProfiler(const char* fname): FileName(fname)
+{
+  this->StartTime = cmSystemTools::GetTime();
+}
+
+//----------------------------------------------------------------------------
+cmProfiler::Entry*
+cmProfiler::GetEntry(std::map<cmStdString, Entry>& entries,
+                     std::string const& name)
+{
+  Entry& e = entries[name];
+  if(e.Name.empty())
+    {
+    e.Name = name;
+    }
+  return &e;
+}
+
+//----------------------------------------------------------------------------
+unsigned int cmProfiler::GetFileIndex(const char* file)
+{
+  std::map<cmStdString, unsigned int>::iterator i =
+    this->FileIndex.find(file);
+  if(i != this->FileIndex.end())
+    {
+    return i->second;
+    }
+  unsigned int index = static_cast<unsigned int>(this->FileNames.size());
+  this->FileNames.push_back(file);
+  this->FileIndex[file] = index;
+  return index;
+}
+
+//----------------------------------------------------------------------------
+void cmProfiler::Start(const char* category, const char* name,
+                       const char* file, long line)
+{
+  bool command = strcmp(category, "command") == 0;
+  Entry* e;
+  if(command)
+    {
+    std::map<cmStdString, Entry*>::iterator i = this->Spellings.find(name);
+    if(i != this->Spellings.end())
+      {
+      e = i->second;
+      }
+    else
+      {
+      e = this->GetEntry(this->Names, cmSystemTools::LowerCase(name));
+      this->Spellings[name] = e;
+      }
+    }
+  else
+    {
+    e = this->GetEntry(this->Names, name);
+    }
+
+  Frame f;
+  f.Name = e;
+  f.File = 0;
+  f.Line = 0;
+  if(command && file && *file)
+    {
+    f.File = this->GetEntry(this->Files, file);
+    char buf[32];
+    sprintf(buf, ":%ld", line);
+    f.Line = this->GetEntry(this->Lines, std::string(file) + buf);
+    }
+  ++e->Calls;
+  ++e->Active;
+  if(f.File)
+    {
+    ++f.File->Calls;
+    ++f.Line->Calls;
+    }
+
+  Event ev;
+  ev.Name = e;
+  ev.Category = command? "command" : category;
+  ev.File = this->GetFileIndex(file? file : "");
+  ev.Line = line;
+  ev.Duration = 0;
+  f.Event = static_cast<unsigned int>(this->Events.size());
+  f.Children = 0;
+  f.Start = cmSystemTools::GetTime();
+  ev.Start = f.Start;
+  this->Events.push_back(ev);
+  this->Stack.push_back(f);
+}
+
+//----------------------------------------------------------------------------
+void cmProfiler::Stop()
+{
+  double now = cmSystemTools::GetTime();
+  if(this->Stack.empty())
+    {
+    return;
+    }
+  Frame f = this->Stack.back();
+  this->Stack.pop_back();
+  double total = now - f.Start;
+  double exclusive = total - f.Children;
+  this->Events[f.Event].Duration = total;
+  f.Name->Exclusive += exclusive;
+  if(--f.Name->Active == 0)
+    {
+    f.Name->Inclusive += total;
+    }
+  if(f.File)
+    {
+    f.File->Exclusive += exclusive;
+    f.Line->Exclusive += exclusive;
+    }
+  if(!this->Stack.empty())
+    {
+    this->Stack.back().Children += total;
+    }
+}
+
+//----------------------------------------------------------------------------
+bool cmProfiler::WriteReport()
+{
+  // Close the frames still open, e.g. after a fatal error.
+  while(!this->Stack.empty())
+    {
+    this->Stop();
+    }
+
+  cmGeneratedFileStream trace(this->FileName.c_str());
+  if(!trace || !this->WriteTrace(trace))
+    {
+    return false;
+    }
+  std::string summaryName = this->FileName + ".txt";
+  cmGeneratedFileStream summary(summaryName.c_str());
+  if(!summary)
+    {
+    return false;
+    }
+  return this->WriteSummary(summary);
+}
+
+//----------------------------------------------------------------------------
+static void cmProfilerWriteJSONString(std::ostream& fout, const char* s)
+{
+  fout << "\"";
+  for(; *s; ++s)
+    {
+    unsigned char c = static_cast<unsigned char>(*s);
+    if(c == '"' || c == '\\')
+      {
+      fout << "\\" << *s;
+      }
+    else if(c < 0x20)
+      {
+      char buf[8];
+      sprintf(buf, "\\u%04x", c);
+      fout << buf;
+      }
+    else
+      {
+      fout << *s;
+      }
+    }
+  fout << "\"";
+}
+
+//----------------------------------------------------------------------------
+bool cmProfiler::WriteTrace(std::ostream& fout)
+{
+  // Complete ("X") events with times in microseconds since the start.
+  fout << "{\"traceEvents\":[";
+  char buf[128];
+  const char* sep = "\n";
+  for(std::vector<Event>::const_iterator i = this->Events.begin();
+      i != this->Events.end(); ++i)
+    {
+    fout << sep << "{\"name\":";
+    cmProfilerWriteJSONString(fout, i->Name->Name.c_str());
+    fout << ",\"cat\":\"" << i->Category << "\",\"ph\":\"X\"";
+    sprintf(buf, ",\"ts\":%.3f,\"dur\":%.3f",
+            (i->Start - this->StartTime) * 1000000, i->Duration * 1000000);
+    fout << buf << ",\"pid\":1,\"tid\":1,\"args\":{\"file\":";
+    cmProfilerWriteJSONString(fout, this->FileNames[i->File].c_str());
+    fout << ",\"line\":" << i->Line << "}}";
+    sep = ",\n";
+    }
+  fout << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  return true;
+}
+
+//----------------------------------------------------------------------------
+struct cmProfilerEntryCompare
+{
+  template <class T>
+  bool operator()(T const* l, T const* r) const
+    {
+    return l->Exclusive > r->Exclusive;
+    }
+};
+
+//----------------------------------------------------------------------------
+void cmProfiler::WriteTable(std::ostream& fout, const char* title,
+                            std::map<cmStdString, Entry>& entries,
+                            bool inclusive, unsigned int limit)
+{
+  std::vector<Entry*> sorted;
+  for(std::map<cmStdString, Entry>::iterator i = entries.begin();
+      i != entries.end(); ++i)
+    {
+    sorted.push_back(&i->second);
+    }
+  std::sort(sorted.begin(), sorted.end(), cmProfilerEntryCompare());
+  if(limit && sorted.size() > limit)
+    {
+    sorted.resize(limit);
+    }
+
+  char buf[128];
+  if(inclusive)
+    {
+    sprintf(buf, "%12s %12s %10s  ", "exclusive", "inclusive", "calls");
+    }
+  else
+    {
+    sprintf(buf, "%12s %10s  ", "exclusive", "calls");
+    }
+  fout << "\n" << buf << title << "\n";
+  for(std::vector<Entry*>::const_iterator i = sorted.begin();
+      i != sorted.end(); ++i)
+    {
+    if(inclusive)
+      {
+      sprintf(buf, "%12.6f %12.6f %10lu  ",
+              (*i)->Exclusive, (*i)->Inclusive, (*i)->Calls);
+      }
+    else
+      {
+      sprintf(buf, "%12.6f %10lu  ", (*i)->Exclusive, (*i)->Calls);
+      }
+    fout << buf << (*i)->Name << "\n";
+    }
+}
+
+//----------------------------------------------------------------------------
+bool cmProfiler::WriteSummary(std::ostream& fout)
+{
+  double total = 0;
+  unsigned long calls = 0;
+  for(std::map<cmStdString, Entry>::const_iterator i = this->Names.begin();
+      i != this->Names.end(); ++i)
+    {
+    total += i->second.Exclusive;
+    calls += i->second.Calls;
+    }
+  char buf[128];
+  sprintf(buf, "%.6f", total);
+  fout << "Profile: " << buf << " s in " << calls << " calls\n";
+
+  unsigned long hits = cmRegularExpressionCache::GetHits();
+  unsigned long misses = cmRegularExpressionCache::GetMisses();
+  sprintf(buf, "%.1f", hits+misses? 100.0*hits/(hits+misses) : 0.0);
+  fout << "Regular expression cache: " << hits << " hits, "
+       << misses << " misses, "
+       << cmRegularExpressionCache::GetEvictions() << " evictions ("
+       << buf << "% hit rate)\n";
+  cmProfiler::WriteTable(fout, "command", this->Names, true, 0);
+  cmProfiler::WriteTable(fout, "listfile", this->Files, false, 0);
+  cmProfiler::WriteTable(fout, "line", this->Lines, false, 100);
+  return true;
+}
@@ -0,0 +1,114 @@
+/*=========================================================================
+
+  Program:   CMake - Cross-Platform Makefile Generator
+  Module:    $RCSfile: cmProfiler.h,v $
+  Language:  C++
+  Date:      $Date: 2008/06/05 16:40:12 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) 2002 Kitware, Inc., Insight Consortium.  All rights reserved.
+  See Copyright.txt or http://www.cmake.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef cmProfiler_h
+#define cmProfiler_h
+
+#include "cmStandardIncludes.h"
+
+/** \class cmProfiler
+ * \brief Measure where the time of a cmake run goes.
+ *
+ * cmProfiler times every command invoked from a listfile, along with
+ * steps that are not commands, such as the configure, generate and
+ * build of a try_compile project.  It aggregates the call count,
+ * inclusive time and exclusive time of every command name, and the
+ * exclusive time spent on every listfile and line.
+ *
+ * The report is written as a Chrome trace event file, which
+ * chrome://tracing and similar viewers show as a timeline, and as a
+ * text summary sorted by exclusive time in the same file name with
+ * ".txt" appended.
+ */
+class cmProfiler
+{
+public:
+  cmProfiler(const char* fname);
+
+  /**
+   * Start timing a command or step.  The file and line tell where a
+   * command was called; steps may pass a directory and 0 instead.
+   * Only commands are counted against their file and line.
+   */
+  void Start(const char* category, const char* name,
+             const char* file, long line);
+
+  /** Stop timing the most recently started command or step.  */
+  void Stop();
+
+  /** Write the trace and the summary.  */
+  bool WriteReport();
+
+  const char* GetFileName() const { return this->FileName.c_str(); }
+
+private:
+  struct Entry
+  {
+    Entry(): Calls(0), Active(0), Inclusive(0), Exclusive(0) {}
+    std::string Name;
+    unsigned long Calls;
+    // number of frames of this entry on the stack; inclusive time is
+    // only counted for the outermost one of a recursion
+    int Active;
+    double Inclusive;
+    double Exclusive;
+  };
+  struct Frame
+  {
+    Entry* Name;
+    Entry* File;
+    Entry* Line;
+    unsigned int Event;
+    double Start;
+    double Children;
+  };
+  struct Event
+  {
+    Entry* Name;
+    const char* Category;
+    unsigned int File;
+    long Line;
+    double Start;
+    double Duration;
+  };
+
+  Entry* GetEntry(std::map<cmStdString, Entry>& entries, std::string const&);
+  unsigned int GetFileIndex(const char* file);
+
+  bool WriteTrace(std::ostream& fout);
+  bool WriteSummary(std::ostream& fout);
+  static void WriteTable(std::ostream& fout, const char* title,
+                         std::map<cmStdString, Entry>& entries,
+                         bool inclusive, unsigned int limit);
+
+  std::string FileName;
+  double StartTime;
+
+  // Commands are reported by their lower case name; remember the
+  // entry of each spelling so that most calls need one lookup.
+  std::map<cmStdString, Entry> Names;
+  std::map<cmStdString, Entry*> Spellings;
+  std::map<cmStdString, Entry> Files;
+  std::map<cmStdString, Entry> Lines;
+
+  std::vector<std::string> FileNames;
+  std::map<cmStdString, unsigned int> FileIndex;
+
+  std::vector<Frame> Stack;
+  std::vector<Event> Events;
+};
+
+#endif
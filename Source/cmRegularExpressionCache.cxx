@@ -0,0 +1,102 @@
+/*=========================================================================
+
+  Program:   CMake - Cross-Platform Makefile Generator
+  Module:    $RCSfile: cmRegularExpressionCache.cxx,v $
+  Language:  C++
+  Date:      $Date: 2008/06/05 16:40:12 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) 2002 Kitware, Inc., Insight Consortium.  All rights reserved.
+  See Copyright.txt or http://www.cmake.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#include "cmRegularExpressionCache.h"
+
+#include <list>
+
+// Number of compiled patterns kept.
+#define CM_REGULAR_EXPRESSION_CACHE_SIZE 256
+
+//----------------------------------------------------------------------------
+class cmRegularExpressionCacheImpl
+{
+public:
+  cmRegularExpressionCacheImpl(): Hits(0), Misses(0), Evictions(0) {}
+  ~cmRegularExpressionCacheImpl()
+    {
+    for(ListType::iterator i = this->Entries.begin();
+        i != this->Entries.end(); ++i)
+      {
+      delete i->second;
+      }
+    }
+
+  // Entries with the most recently used first.
+  typedef std::list<std::pair<cmStdString, cmsys::RegularExpression*> >
+    ListType;
+  ListType Entries;
+  std::map<cmStdString, ListType::iterator> Index;
+  unsigned long Hits;
+  unsigned long Misses;
+  unsigned long Evictions;
+};
+
+static cmRegularExpressionCacheImpl cmRegularExpressionCacheInstance;
+
+//----------------------------------------------------------------------------
+cmsys::RegularExpression const*
+cmRegularExpressionCache::Get(const char* pattern)
+{
+  cmRegularExpressionCacheImpl& cache = cmRegularExpressionCacheInstance;
+  std::map<cmStdString, cmRegularExpressionCacheImpl::ListType::iterator>
+    ::iterator i = cache.Index.find(pattern);
+  if(i != cache.Index.end())
+    {
+    ++cache.Hits;
+    cache.Entries.splice(cache.Entries.begin(), cache.Entries, i->second);
+    return i->second->second;
+    }
+
+  // Patterns that do not compile are not kept, so their error is
+  // reported on every evaluation as before.
+  ++cache.Misses;
+  cmsys::RegularExpression* re = new cmsys::RegularExpression;
+  if(!re->compile(pattern))
+    {
+    delete re;
+    return 0;
+    }
+  if(cache.Index.size() >= CM_REGULAR_EXPRESSION_CACHE_SIZE)
+    {
+    ++cache.Evictions;
+    delete cache.Entries.back().second;
+    cache.Index.erase(cache.Entries.back().first);
+    cache.Entries.pop_back();
+    }
+  cache.Entries.push_front(
+    cmRegularExpressionCacheImpl::ListType::value_type(pattern, re));
+  cache.Index[pattern] = cache.Entries.begin();
+  return re;
+}
+
+//----------------------------------------------------------------------------
+unsigned long cmRegularExpressionCache::GetHits()
+{
+  return cmRegularExpressionCacheInstance.Hits;
+}
+
+//----------------------------------------------------------------------------
+unsigned long cmRegularExpressionCache::GetMisses()
+{
+  return cmRegularExpressionCacheInstance.Misses;
+}
+
+//----------------------------------------------------------------------------
+unsigned long cmRegularExpressionCache::GetEvictions()
+{
+  return cmRegularExpressionCacheInstance.Evictions;
+}
@@ -0,0 +1,48 @@
+/*=========================================================================
+
+  Program:   CMake - Cross-Platform Makefile Generator
+  Module:    $RCSfile: cmRegularExpressionCache.h,v $
+  Language:  C++
+  Date:      $Date: 2008/06/05 16:40:12 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) 2002 Kitware, Inc., Insight Consortium.  All rights reserved.
+  See Copyright.txt or http://www.cmake.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef cmRegularExpressionCache_h
+#define cmRegularExpressionCache_h
+
+#include "cmStandardIncludes.h"
+
+#include <cmsys/RegularExpression.hxx>
+
+/** \class cmRegularExpressionCache
+ * \brief Compile each regular expression pattern once per process.
+ *
+ * string(REGEX), if(MATCHES) and file(STRINGS REGEX) used to compile
+ * their pattern on every evaluation, which dominates loops that match
+ * the same few patterns many times.  This keeps the most recently used
+ * compiled patterns, dropping the least recently used one when full.
+ */
+class cmRegularExpressionCache
+{
+public:
+  /**
+   * Return the compiled form of the pattern, or null if it does not
+   * compile.  The result is valid until the next call.  Copy it to
+   * match so the match state of nested evaluations stays separate.
+   */
+  static cmsys::RegularExpression const* Get(const char* pattern);
+
+  /** Counters for the hit rate of the cache.  */
+  static unsigned long GetHits();
+  static unsigned long GetMisses();
+  static unsigned long GetEvictions();
+};
+
+#endif
@@ -15,6 +15,8 @@
 
 =========================================================================*/
 #include "cmStringCommand.h"
+#include "cmRegularExpressionCache.h"
+
 #include <cmsys/RegularExpression.hxx>
 #include <cmsys/SystemTools.hxx>
 
@@ -83,6 +85,45 @@ bool cmStringCommand
   return false;
 }
 
+//----------------------------------------------------------------------------
+std::string
+cmStringCommand::GetLuaResultVariable(std::vector<std::string> const& args)
+{
+  if(args.empty())
+    {
+    return std::string();
+    }
+  const std::string &subCommand = args[0];
+  unsigned int index = 0;
+  if(subCommand == "REGEX" && args.size() > 1)
+    {
+    index = args[1] == "REPLACE"? 4 : 3;
+    }
+  else if(subCommand == "REPLACE")
+    {
+    index = 3;
+    }
+  else if(subCommand == "SUBSTRING" || subCommand == "COMPARE")
+    {
+    index = 4;
+    }
+  else if(subCommand == "TOLOWER" || subCommand == "TOUPPER" ||
+          subCommand == "CONFIGURE" || subCommand == "LENGTH" ||
+          subCommand == "STRIP")
+    {
+    index = 2;
+    }
+  else if(subCommand == "ASCII" || subCommand == "RANDOM")
+    {
+    index = static_cast<unsigned int>(args.size()) - 1;
+    }
+  if(index == 0 || index >= args.size())
+    {
+    return std::string();
+    }
+  return args[index];
+}
+
 //----------------------------------------------------------------------------
 bool cmStringCommand::HandleToUpperLowerCommand(
   std::vector<std::string> const& args, bool toUpper)
@@ -251,14 +292,16 @@ bool cmStringCommand::RegexMatch(std::vector<std::string> const& args)
   
   this->ClearMatches(this->Makefile);
   // Compile the regular expression.
-  cmsys::RegularExpression re;
-  if(!re.compile(regex.c_str()))
+  cmsys::RegularExpression const* compiled =
+    cmRegularExpressionCache::Get(regex.c_str());
+  if(!compiled)
     {
     std::string e = 
       "sub-command REGEX, mode MATCH failed to compile regex \""+regex+"\".";
     this->SetError(e.c_str());
     return false;
     }
+  cmsys::RegularExpression re(*compiled);
   
   // Scan through the input for all matches.
   std::string output;
@@ -300,8 +343,9 @@ bool cmStringCommand::RegexMatchAll(std::vector<std::string> const& args)
   
   this->ClearMatches(this->Makefile);
   // Compile the regular expression.
-  cmsys::RegularExpression re;
-  if(!re.compile(regex.c_str()))
+  cmsys::RegularExpression const* compiled =
+    cmRegularExpressionCache::Get(regex.c_str());
+  if(!compiled)
     {
     std::string e =
       "sub-command REGEX, mode MATCHALL failed to compile regex \""+
@@ -309,6 +353,7 @@ bool cmStringCommand::RegexMatchAll(std::vector<std::string> const& args)
     this->SetError(e.c_str());
     return false;
     }
+  cmsys::RegularExpression re(*compiled);
   
   // Scan through the input for all matches.
   std::string output;
@@ -404,8 +449,9 @@ bool cmStringCommand::RegexReplace(std::vector<std::string> const& args)
   
   this->ClearMatches(this->Makefile);
   // Compile the regular expression.
-  cmsys::RegularExpression re;
-  if(!re.compile(regex.c_str()))
+  cmsys::RegularExpression const* compiled =
+    cmRegularExpressionCache::Get(regex.c_str());
+  if(!compiled)
     {
     std::string e = 
       "sub-command REGEX, mode REPLACE failed to compile regex \""+
@@ -413,6 +459,7 @@ bool cmStringCommand::RegexReplace(std::vector<std::string> const& args)
     this->SetError(e.c_str());
     return false;
     }
+  cmsys::RegularExpression re(*compiled);
   
   // Scan through the input for all matches.
   std::string output;
@@ -1589,6 +1589,18 @@ void cmSystemTools::EnableVSConsoleOutput()
 #endif
 }
 
+unsigned int cmSystemTools::GetNumberOfProcessors()
+{
+  long n = 0;
+#if defined(_WIN32)
+  const char* env = cmSystemTools::GetEnv("NUMBER_OF_PROCESSORS");
+  n = env? atol(env) : 0;
+#elif defined(_SC_NPROCESSORS_ONLN)
+  n = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+  return n > 0? static_cast<unsigned int>(n) : 1;
+}
+
 std::string cmSystemTools::MakeXMLSafe(const char* str)
 {
   std::vector<char> result;
@@ -339,6 +339,10 @@ public:
   /** Setup the environment to enable VS 8 IDE output.  */
   static void EnableVSConsoleOutput();
 
+  /** Get the number of processors available to run jobs, or 1 if it
+      cannot be determined.  */
+  static unsigned int GetNumberOfProcessors();
+
   /** Make string XML safe */
   static std::string MakeXMLSafe(const char* str);
 
@@ -25,7 +25,14 @@ bool cmTryCompileCommand
     return false;
     }
 
-  this->TryCompileCode(argv);
+  if(cmTryCompileCommand::IsBatch(argv))
+    {
+    this->TryCompileBatch(argv);
+    }
+  else
+    {
+    this->TryCompileCode(argv, true);
+    }
 
   // if They specified clean then we clean up what we can
   if (this->SrcFileSignature)
@@ -42,6 +42,29 @@ public:
   virtual bool InitialPass(std::vector<std::string> const& args,
                            cmExecutionStatus &status);
 
+  /**
+   * try_compile(RESULT_VAR ...) stores whether the build worked.  The
+   * batch form has one result per source and returns none.
+   */
+  virtual std::string
+  GetLuaResultVariable(std::vector<std::string> const& args)
+    {
+    if(cmTryCompileCommand::IsBatch(args))
+      {
+      return std::string();
+      }
+    return cmCommand::GetFirstArgument(args);
+    }
+
+  /**
+   * Whether the arguments use try_compile(BATCH bindir SOURCES ...).
+   * A result variable named BATCH keeps the other forms working.
+   */
+  static bool IsBatch(std::vector<std::string> const& args)
+    {
+    return args.size() > 2 && args[0] == "BATCH" && args[2] == "SOURCES";
+    }
+
   /**
    * The name of the command as specified in CMakeList.txt.
    */
@@ -93,12 +116,35 @@ public:
       "  link_directories(${LINK_DIRECTORIES})\n"
       "  add_executable(cmTryCompileExec sources)\n"
       "  target_link_libraries(cmTryCompileExec ${LINK_LIBRARIES})\n"
+      "For simple C and C++ builds with the Unix Makefiles generator the "
+      "compiler is run directly with the commands this project would "
+      "run, see CMAKE_TRY_COMPILE_DIRECT.\n"
       "In both versions of the command, "
       "if OUTPUT_VARIABLE is specified, then the "
       "output from the build process is stored in the given variable. "
       "Return the success or failure in "
       "RESULT_VAR. CMAKE_FLAGS can be used to pass -DVAR:TYPE=VALUE flags "
       "to the cmake that is run during the build. "
+      "\n"
+      "  try_compile(BATCH bindir\n"
+      "              SOURCES RESULT_VAR srcfile [RESULT_VAR srcfile ...]\n"
+      "              [CMAKE_FLAGS <Flags>]\n"
+      "              [COMPILE_DEFINITIONS <flags> ...]\n"
+      "              [OUTPUT_VARIABLE var])\n"
+      "Try compiling several independent srcfiles at once.  This form "
+      "is used only when SOURCES follows bindir, so a RESULT_VAR named "
+      "BATCH still works with the other forms.  It works "
+      "like the srcfile form, but the generated CMakeLists.txt file has "
+      "one executable for every srcfile, named cmTryCompileExec0, "
+      "cmTryCompileExec1 and so on, and the project is configured and "
+      "built only once.  "
+      "Each RESULT_VAR is set to whether its srcfile could be built.  "
+      "The CMAKE_FLAGS and COMPILE_DEFINITIONS apply to all srcfiles, "
+      "and OUTPUT_VARIABLE gets the output of the whole build.  "
+      "With the makefile generators whose make program can, the "
+      "executables are built in parallel, with as many jobs as "
+      "CMAKE_TRY_COMPILE_BATCH_JOBS says or else as there are "
+      "processors.  "
       "";
     }
   
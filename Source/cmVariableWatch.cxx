@@ -96,3 +96,8 @@ void  cmVariableWatch::VariableAccessed(const std::string& variable,
       }
     }
 }
+
+bool cmVariableWatch::IsWatched(const char* variable) const
+{
+  return this->WatchMap.find(variable) != this->WatchMap.end();
+}
@@ -48,6 +48,11 @@ public:
   void VariableAccessed(const std::string& variable, int access_type,
     const char* newValue, const cmMakefile* mf) const;
 
+  /**
+   * Return true if there is a watch on the variable
+   */
+  bool IsWatched(const char* variable) const;
+
   /**
    * Different access types.
    */
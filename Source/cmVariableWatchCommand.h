@@ -41,6 +41,11 @@ public:
     return new cmVariableWatchCommand;
     }
 
+  /**
+   * The watches this command adds call back into it.
+   */
+  virtual bool IsUsedAfterInitialPass() const { return true; }
+
   //! Default constructor
   cmVariableWatchCommand();
 
@@ -60,12 +60,22 @@ public:
     return new cmWhileCommand;
     }
 
+  /**
+   * This determines if one instance may run many invocations.
+   */
+  virtual bool IsReusable() { return true; }
+
   /**
    * This overrides the default InvokeInitialPass implementation.
    * It records the arguments before expansion.
    */
   virtual bool InvokeInitialPass(const std::vector<cmListFileArgument>& args,
                                  cmExecutionStatus &);
+
+  /**
+   * The condition is evaluated from the unexpanded arguments.
+   */
+  virtual bool AcceptsDirectArguments() { return false; }
     
   /**
    * This is called when the command is first encountered in
@@ -24,12 +24,16 @@
 #include "cmCommands.h"
 #include "cmCommand.h"
 #include "cmFileTimeComparison.h"
+#include "cmListFileCache.h"
 #include "cmGeneratedFileStream.h"
 #include "cmSourceFile.h"
 #include "cmVersion.h"
 #include "cmTest.h"
 #include "cmDocumentationFormatterText.h"
 #include "cmLuaUtils.h"
+#include "cmLuaProfiler.h"
+#include "cmProfiler.h"
+#include "cmLuaAllocator.h"
 
 extern "C" {
 #include "lua.h"
@@ -146,6 +150,11 @@ void cmNeedBackwardsCompatibility(const std::string& variable,
 #endif
 }
 
+// Command table versions are unique across all cmake instances, so a
+// resolved command kept with a listfile function never matches another
+// instance by accident.
+static unsigned long cmakeCommandsGeneration = 0;
+
 cmake::cmake()
 {
   this->SuppressDevWarnings = false;
@@ -154,6 +163,7 @@ cmake::cmake()
   this->DebugTryCompile = false;
   this->ClearBuildSystem = false;
   this->FileComparison = new cmFileTimeComparison;
+  this->ListFileCache = new cmListFileCache;
 
   this->Policies = new cmPolicies();
   this->InitializeProperties();
@@ -182,6 +192,7 @@ cmake::cmake()
 
   this->Verbose = false;
   this->InTryCompile = false;
+  this->CommandsGeneration = ++cmakeCommandsGeneration;
   this->CacheManager = new cmCacheManager;
   this->GlobalGenerator = 0;
   this->ProgressCallback = 0;
@@ -199,12 +210,16 @@ cmake::cmake()
 #endif
 
   // setup lua
-  this->LuaState = lua_open(); 
+  this->LuaAllocator = new cmLuaAllocator;
+  this->CurrentLuaMakefile = 0;
+  this->LuaState = lua_newstate(&cmLuaAllocator::Alloc, this->LuaAllocator);
   luaL_openlibs(this->LuaState);
+  this->LuaProfiler = 0;
+  this->LuaDirectCalls = 0;
+  this->LuaListFileCalls = 0;
 
-  // setup lua
-  this->LuaState = lua_open(); 
-  luaL_openlibs(this->LuaState);
+  this->Profiler = 0;
+  this->ProfilerOwned = false;
 
   this->AddDefaultGenerators();
   this->AddDefaultExtraGenerators();
@@ -232,8 +247,42 @@ cmake::~cmake()
   delete this->VariableWatch;
 #endif
   delete this->FileComparison;
+  delete this->ListFileCache;
 
   lua_close(this->LuaState);
+  delete this->LuaAllocator;
+  delete this->LuaProfiler;
+  if(this->ProfilerOwned)
+    {
+    delete this->Profiler;
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmake::SetProfiler(cmProfiler* profiler)
+{
+  if(this->ProfilerOwned)
+    {
+    delete this->Profiler;
+    }
+  this->Profiler = profiler;
+  this->ProfilerOwned = false;
+}
+
+//----------------------------------------------------------------------------
+void cmake::WriteProfile()
+{
+  if(!this->Profiler || !this->ProfilerOwned)
+    {
+    return;
+    }
+  std::cout << "Write profile: " << this->Profiler->GetFileName()
+            << std::endl;
+  if(!this->Profiler->WriteReport())
+    {
+    cmSystemTools::Error("Could not write profile ",
+                         this->Profiler->GetFileName());
+    }
 }
 
 void cmake::InitializeProperties()
@@ -269,6 +318,7 @@ void cmake::CleanupCommandsAndMacros()
       }
     }
   this->Commands.erase(this->Commands.begin(), this->Commands.end());
+  this->CommandsGeneration = ++cmakeCommandsGeneration;
   std::vector<cmCommand*>::iterator it;
   for ( it = commands.begin(); it != commands.end();
     ++ it )
@@ -295,6 +345,18 @@ cmCommand *cmake::GetCommand(const char *name)
   return rm;
 }
 
+cmCommand *cmake::ResolveCommand(const cmListFileFunction& lff)
+{
+  if(lff.CommandOwner != this ||
+     lff.CommandGeneration != this->CommandsGeneration)
+    {
+    lff.Command = this->GetCommand(lff.Name.c_str());
+    lff.CommandOwner = this;
+    lff.CommandGeneration = this->CommandsGeneration;
+    }
+  return lff.Command;
+}
+
 void cmake::RenameCommand(const char*oldName, const char* newName)
 {
   // if the command already exists, free the old one
@@ -316,6 +378,7 @@ void cmake::RenameCommand(const char*oldName, const char* newName)
   this->Commands.insert(RegisteredCommandsMap::value_type(sNewName, cmd));
   pos = this->Commands.find(sOldName);
   this->Commands.erase(pos);
+  this->CommandsGeneration = ++cmakeCommandsGeneration;
 }
 
 void cmake::RemoveCommand(const char* name)
@@ -326,6 +389,7 @@ void cmake::RemoveCommand(const char* name)
     {
     delete pos->second;
     this->Commands.erase(pos);
+    this->CommandsGeneration = ++cmakeCommandsGeneration;
     }
 }
 
@@ -340,6 +404,7 @@ void cmake::AddCommand(cmCommand* wg)
     this->Commands.erase(pos);
     }
   this->Commands.insert( RegisteredCommandsMap::value_type(name, wg));
+  this->CommandsGeneration = ++cmakeCommandsGeneration;
 
   // add to Lua
   if (wg->GetExposeToLua())
@@ -347,7 +412,8 @@ void cmake::AddCommand(cmCommand* wg)
 //#define CMAKELUA_NO_NAMESPACE
 #ifdef CMAKELUA_NO_NAMESPACE
     lua_pushstring(this->LuaState, name.c_str());
-    lua_pushcclosure(this->LuaState, wg->LuaFunction, 1);
+    lua_pushlightuserdata(this->LuaState, this);
+    lua_pushcclosure(this->LuaState, wg->LuaFunction, 2);
   
     // lua name is cm_*
     std::string fname = "cm_";
@@ -356,11 +422,23 @@ void cmake::AddCommand(cmCommand* wg)
 #else
 	const char* cmakelua_api_namespace = "cmake";
 //	std::cerr << "RegisterFunc for: " << name << ".\n";
-	LuaUtils_RegisterFunc(this->LuaState, wg->LuaFunction, name.c_str(), cmakelua_api_namespace);
+	LuaUtils_RegisterFunc(this->LuaState, wg->LuaFunction, name.c_str(), cmakelua_api_namespace, this);
 #endif
     }
 }
 
+cmMakefile* cmake::SetCurrentLuaMakefile(lua_State* L, cmMakefile* mf)
+{
+  // The command bindings carry the cmake instance and find it here.
+  // The registry entry serves Lua code run while none is set.
+  cmMakefile* previous = this->CurrentLuaMakefile;
+  this->CurrentLuaMakefile = mf;
+  lua_pushstring(L, "cmCurrentMakefile");
+  lua_pushlightuserdata(L, mf);
+  lua_settable(L, LUA_REGISTRYINDEX);
+  return previous;
+}
+
 
 void cmake::RemoveUnscriptableCommands()
 {
@@ -647,6 +725,36 @@ void cmake::SetArgs(const std::vector<std::string>& args)
         cmSystemTools::Error("No file specified for --graphviz");
         }
       }
+    else if(arg.find("--profile-lua=",0) == 0)
+      {
+      std::string path = arg.substr(strlen("--profile-lua="));
+      if(path.empty())
+        {
+        cmSystemTools::Error("No file specified for --profile-lua");
+        }
+      else if(!this->LuaProfiler)
+        {
+        path = cmSystemTools::CollapseFullPath(path.c_str());
+        cmSystemTools::ConvertToUnixSlashes(path);
+        this->LuaProfiler = new cmLuaProfiler(path.c_str());
+        this->LuaProfiler->Attach(this->LuaState);
+        }
+      }
+    else if(arg.find("--profile=",0) == 0)
+      {
+      std::string path = arg.substr(strlen("--profile="));
+      if(path.empty())
+        {
+        cmSystemTools::Error("No file specified for --profile");
+        }
+      else if(!this->Profiler)
+        {
+        path = cmSystemTools::CollapseFullPath(path.c_str());
+        cmSystemTools::ConvertToUnixSlashes(path);
+        this->Profiler = new cmProfiler(path.c_str());
+        this->ProfilerOwned = true;
+        }
+      }
     else if(arg.find("--debug-trycompile",0) == 0)
       {
       std::cout << "debug trycompile on\n";
@@ -2141,8 +2249,26 @@ int cmake::ActualConfigure()
     this->TruncateOutputLog("CMakeError.log");
     }
 
+  // Optionally start from the listfiles parsed by the last run.
+  std::string listFileCacheFile;
+  if(!this->ScriptMode && cmSystemTools::IsOn(
+       this->CacheManager->GetCacheValue("CMAKE_PERSIST_LISTFILE_CACHE")))
+    {
+    listFileCacheFile = this->GetHomeOutputDirectory();
+    listFileCacheFile += this->GetCMakeFilesDirectory();
+    listFileCacheFile += "/ListFileCache.txt";
+    this->ListFileCache->Load(listFileCacheFile.c_str());
+    }
+
   // actually do the configure
   this->GlobalGenerator->Configure();
+
+  if(!listFileCacheFile.empty() &&
+     !this->ListFileCache->Save(listFileCacheFile.c_str()))
+    {
+    cmSystemTools::Error("Could not write listfile cache ",
+                         listFileCacheFile.c_str());
+    }
   // Before saving the cache
   // if the project did not define one of the entries below, add them now
   // so users can edit the values in the cache:
@@ -2195,6 +2321,16 @@ int cmake::ActualConfigure()
     std::cout << "Generate graphviz: " << this->GraphVizFile << std::endl;
     this->GenerateGraphViz(this->GraphVizFile.c_str());
     }
+  if(this->LuaProfiler)
+    {
+    std::cout << "Write Lua profile: " << this->LuaProfiler->GetFileName()
+              << std::endl;
+    if(!this->LuaProfiler->WriteReport())
+      {
+      cmSystemTools::Error("Could not write Lua profile ",
+                           this->LuaProfiler->GetFileName());
+      }
+    }
   if(cmSystemTools::GetErrorOccuredFlag())
     {
     return -1;
@@ -2294,6 +2430,7 @@ int cmake::Run(const std::vector<std::string>& args, bool noconfigure)
   // In script mode we terminate after running the script.
   if(this->ScriptMode)
     {
+    this->WriteProfile();
     if(cmSystemTools::GetErrorOccuredFlag())
       {
       return -1;
@@ -2327,9 +2464,19 @@ int cmake::Run(const std::vector<std::string>& args, bool noconfigure)
   std::string oldstartoutputdir = this->GetStartOutputDirectory();
   this->SetStartDirectory(this->GetHomeDirectory());
   this->SetStartOutputDirectory(this->GetHomeOutputDirectory());
+  if(this->Profiler)
+    {
+    this->Profiler->Start("cmake", "configure",
+                          this->GetHomeDirectory(), 0);
+    }
   int ret = this->Configure();
+  if(this->Profiler)
+    {
+    this->Profiler->Stop();
+    }
   if (ret || this->ScriptMode)
     {
+    this->WriteProfile();
 #if defined(CMAKE_HAVE_VS_GENERATORS)
     if(!this->VSSolutionFile.empty() && this->GlobalGenerator)
       {
@@ -2348,10 +2495,20 @@ int cmake::Run(const std::vector<std::string>& args, bool noconfigure)
 #endif
     return ret;
     }
+  if(this->Profiler)
+    {
+    this->Profiler->Start("cmake", "generate",
+                          this->GetHomeOutputDirectory(), 0);
+    }
   ret = this->Generate();
+  if(this->Profiler)
+    {
+    this->Profiler->Stop();
+    }
   std::string message = "Build files have been written to: ";
   message += this->GetHomeOutputDirectory();
   this->UpdateProgress(message.c_str(), -1);
+  this->WriteProfile();
   if(ret)
     {
     return ret;
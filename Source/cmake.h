@@ -51,7 +51,12 @@ class cmMakefile;
 class cmCommand;
 class cmVariableWatch;
 class cmFileTimeComparison;
+class cmListFileCache;
+struct cmListFileFunction;
 struct lua_State;
+class cmLuaProfiler;
+class cmProfiler;
+class cmLuaAllocator;
 class cmExternalMakefileProjectGenerator;
 class cmDocumentationSection;
 class cmPolicies;
@@ -220,6 +225,13 @@ class cmake
   /** Get list of all commands */
   RegisteredCommandsMap* GetCommands() { return &this->Commands; }
 
+  /**
+   * Get the command a listfile function calls, or null if there is
+   * none.  The result is kept with the function until a command is
+   * added, renamed or removed, so repeated calls need no lookup.
+   */
+  cmCommand *ResolveCommand(const cmListFileFunction& lff);
+
   /** Check if a command exists. */
   bool CommandExists(const char* name) const;
     
@@ -310,6 +322,11 @@ class cmake
    */
   cmFileTimeComparison* GetFileComparison() { return this->FileComparison; }
 
+  /**
+   * Get the cache of parsed listfiles for this run
+   */
+  cmListFileCache* GetListFileCache() { return this->ListFileCache; }
+
   /**
    * Get the path to ctest
    */
@@ -356,8 +373,33 @@ class cmake
   void IssueMessage(cmake::MessageType t, std::string const& text,
                     cmListFileBacktrace const& backtrace);
 
+  /** Return the profiler enabled by --profile, or 0.  */
+  cmProfiler* GetProfiler() { return this->Profiler; }
+
+  /** Share the profiler of another instance, e.g. for a try_compile
+      project.  The given profiler is not deleted by this instance.  */
+  void SetProfiler(cmProfiler* profiler);
+
   // return the Lua state for lua commands
   lua_State *GetLuaState() { return this->LuaState;};
+
+  // the allocator of the Lua state of this instance
+  cmLuaAllocator* GetLuaAllocator() { return this->LuaAllocator; }
+
+  // the makefile whose Lua code runs now, which cmake.* calls act on;
+  // setting it returns the previous one
+  cmMakefile* GetCurrentLuaMakefile() { return this->CurrentLuaMakefile; }
+  cmMakefile* SetCurrentLuaMakefile(lua_State* L, cmMakefile* mf);
+
+  // count cmake.* calls from Lua and whether they skipped the
+  // listfile argument expansion
+  void RecordLuaCommandCall(bool direct)
+    {
+    if(direct) { ++this->LuaDirectCalls; }
+    else { ++this->LuaListFileCalls; }
+    }
+  unsigned long GetLuaDirectCalls() { return this->LuaDirectCalls; }
+  unsigned long GetLuaListFileCalls() { return this->LuaListFileCalls; }
 protected:
   void InitializeProperties();
   int HandleDeleteCacheVariables(const char* var);
@@ -376,6 +418,7 @@ protected:
   typedef std::map<cmStdString,
                    CreateGeneratorFunctionType> RegisteredGeneratorsMap;
   RegisteredCommandsMap Commands;
+  unsigned long CommandsGeneration;
   RegisteredGeneratorsMap Generators;
   RegisteredExtraGeneratorsMap ExtraGenerators;
   void AddDefaultCommands();
@@ -458,11 +501,20 @@ private:
   bool ClearBuildSystem;
   bool DebugTryCompile;
   cmFileTimeComparison* FileComparison;
+  cmListFileCache* ListFileCache;
   std::string GraphVizFile;
   
   void UpdateConversionPathTable();
 
   lua_State *LuaState;
+  cmLuaProfiler* LuaProfiler;
+  cmProfiler* Profiler;
+  bool ProfilerOwned;
+  void WriteProfile();
+  cmLuaAllocator* LuaAllocator;
+  cmMakefile* CurrentLuaMakefile;
+  unsigned long LuaDirectCalls;
+  unsigned long LuaListFileCalls;
 };
 
 #define CMAKE_STANDARD_OPTIONS_TABLE \
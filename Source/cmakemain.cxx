@@ -101,6 +101,22 @@ static const char * cmDocumentationOptions[][3] =
   {"--debug-output", "Put cmake in a debug mode.",
    "Print extra stuff during the cmake run like stack traces with "
    "message(send_error ) calls."},
+  {"--profile-lua=[file]", "Profile Lua listfiles during configure.",
+   "Measure the number of calls, the inclusive time and the exclusive time "
+   "of every Lua function and cmake.* command called while the project "
+   "is configured.  If the file name contains \"callgrind\" the report "
+   "is written in callgrind format for use with tools like KCachegrind, "
+   "otherwise a flat table sorted by exclusive time is written."},
+  {"--profile=[file]", "Profile the commands run by cmake.",
+   "Measure the wall time and number of calls of every command name, "
+   "listfile and line, including the configure, generate and build steps "
+   "of try_compile projects.  The file is written as a Chrome trace event "
+   "file that chrome://tracing can show as a timeline.  A text summary "
+   "sorted by exclusive time is written next to it with \".txt\" "
+   "appended to the file name.  The summary also reports the hit rate "
+   "of the cache of compiled regular expressions.  With "
+   "CMAKE_COMPILE_LISTFILES the time of if, elseif, while and foreach "
+   "is that of evaluating their conditions and loop arguments."},
   {"--help-command cmd [file]", "Print help for a single command and exit.",
    "Full documentation specific to the given command is displayed. "
    "If a file is specified, the documentation is written into and the output "
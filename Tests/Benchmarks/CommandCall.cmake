@@ -0,0 +1,19 @@
+# The fixed cost of running a command: finding it by name and getting
+# an instance of it.  Three cheap builtins are called CALLS times each.
+
+get_filename_component(benchmark_list_dir "${CMAKE_CURRENT_LIST_FILE}" PATH)
+include("${benchmark_list_dir}/Parameters.cmake")
+benchmark_parameter(CALLS 100000)
+
+foreach(i RANGE 1 ${CALLS})
+  set(benchmark_a ${i})
+  get_filename_component(benchmark_b /a/b/c.txt NAME)
+  string(LENGTH "${benchmark_b}" benchmark_c)
+endforeach(i)
+
+if(NOT "${benchmark_a} ${benchmark_b} ${benchmark_c}" STREQUAL
+    "${CALLS} c.txt 5")
+  message(FATAL_ERROR "unexpected result")
+endif(NOT "${benchmark_a} ${benchmark_b} ${benchmark_c}" STREQUAL
+  "${CALLS} c.txt 5")
+message(STATUS "${CALLS} iterations of 3 commands")
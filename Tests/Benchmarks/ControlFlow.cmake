@@ -0,0 +1,43 @@
+# The if(), foreach() and while() blocks themselves, with bodies too
+# small to matter: an if/elseif/else chain in a foreach() loop of ITEMS
+# iterations, a while() loop as long and a function() leaving a loop
+# with break().  Compare with -DCMAKE_COMPILE_LISTFILES=ON.
+
+get_filename_component(benchmark_list_dir "${CMAKE_CURRENT_LIST_FILE}" PATH)
+include("${benchmark_list_dir}/Parameters.cmake")
+benchmark_parameter(ITEMS 20000)
+
+foreach(i RANGE 1 ${ITEMS})
+  if(i GREATER 10)
+    set(benchmark_big ${i})
+  elseif(i EQUAL 5)
+    set(benchmark_five ${i})
+  else(i GREATER 10)
+    set(benchmark_small ${i})
+  endif(i GREATER 10)
+endforeach(i)
+
+set(j 0)
+while(j LESS ${ITEMS})
+  math(EXPR j "${j}+1")
+endwhile(j LESS ${ITEMS})
+
+function(benchmark_function count)
+  set(found "")
+  foreach(k RANGE 1 ${count})
+    if(k EQUAL ${count})
+      set(found ${k})
+      break()
+    endif(k EQUAL ${count})
+  endforeach(k)
+  set(benchmark_found ${found} PARENT_SCOPE)
+endfunction(benchmark_function)
+benchmark_function(${ITEMS})
+
+set(expect "${ITEMS} 5 10 ${ITEMS} ${ITEMS}")
+set(actual "${benchmark_big} ${benchmark_five} ${benchmark_small} ${j}")
+set(actual "${actual} ${benchmark_found}")
+if(NOT "${actual}" STREQUAL "${expect}")
+  message(FATAL_ERROR "unexpected result \"${actual}\"")
+endif(NOT "${actual}" STREQUAL "${expect}")
+message(STATUS "${ITEMS} loop iterations")
@@ -0,0 +1,114 @@
+# Reading and scanning files for the implicit dependencies of C code,
+# the work "make depend" does on a build tree nothing was scanned in.
+# A project of SOURCES sources over HEADERS headers is generated and
+# configured once.  Each file includes INCLUDES headers among LINES
+# lines of other code.  Its dependencies are then scanned SCANS times
+# from scratch.  JOBS sets CMAKE_DEPENDS_SCAN_JOBS, the number of
+# threads scanning.
+
+get_filename_component(benchmark_list_dir "${CMAKE_CURRENT_LIST_FILE}" PATH)
+include("${benchmark_list_dir}/Parameters.cmake")
+benchmark_parameter(HEADERS 400)
+benchmark_parameter(SOURCES 100)
+benchmark_parameter(INCLUDES 8)
+benchmark_parameter(LINES 200)
+benchmark_parameter(SCANS 10)
+
+set(benchmark_dir "${CMAKE_CURRENT_BINARY_DIR}/DependScan")
+set(benchmark_dir "${benchmark_dir}-${HEADERS}-${SOURCES}")
+set(benchmark_dir "${benchmark_dir}-${INCLUDES}-${LINES}")
+set(benchmark_src "${benchmark_dir}/src")
+set(benchmark_bin "${benchmark_dir}/bin${JOBS}")
+
+if(NOT EXISTS "${benchmark_src}/CMakeLists.txt")
+  # Filler code shared by all files.  It has preprocessor lines that
+  # are not include directives so the scanner has to look at them.
+  set(benchmark_filler "")
+  foreach(i RANGE 1 ${LINES} 4)
+    set(benchmark_filler "${benchmark_filler}/* comment line ${i} */
+#if defined(BENCHMARK_${i})
+static int benchmark_value_${i}(int x) { return x + ${i}; }
+#endif
+")
+  endforeach(i)
+
+  # Header i includes headers chosen among those numbered below i so
+  # the graph has no cycles but headers are shared by many includers.
+  math(EXPR benchmark_last "${HEADERS} - 1")
+  foreach(i RANGE 0 ${benchmark_last})
+    set(benchmark_content "#ifndef H${i}_H\n#define H${i}_H\n")
+    if(i GREATER 0)
+      foreach(k RANGE 1 ${INCLUDES})
+        math(EXPR j "(${i} * 7 + ${k} * 13) % ${i}")
+        set(benchmark_content "${benchmark_content}#include \"h${j}.h\"\n")
+      endforeach(k)
+    endif(i GREATER 0)
+    file(WRITE "${benchmark_src}/include/h${i}.h"
+      "${benchmark_content}${benchmark_filler}#endif\n")
+  endforeach(i)
+
+  set(benchmark_sources "")
+  math(EXPR benchmark_last "${SOURCES} - 1")
+  foreach(i RANGE 0 ${benchmark_last})
+    set(benchmark_content "#include <stdio.h>\n")
+    foreach(k RANGE 1 ${INCLUDES})
+      math(EXPR j "(${i} * 31 + ${k} * 17) % ${HEADERS}")
+      set(benchmark_content "${benchmark_content}#include <h${j}.h>\n")
+    endforeach(k)
+    file(WRITE "${benchmark_src}/s${i}.c"
+      "${benchmark_content}${benchmark_filler}"
+      "int s${i}(void) { return ${i}; }\n")
+    set(benchmark_sources "${benchmark_sources} s${i}.c")
+  endforeach(i)
+
+  file(WRITE "${benchmark_src}/CMakeLists.txt"
+    "cmake_minimum_required(VERSION 2.6)\n"
+    "project(DependScan C)\n"
+    "include_directories(\${DependScan_SOURCE_DIR}/include)\n"
+    "add_library(DependScan STATIC${benchmark_sources})\n")
+endif(NOT EXISTS "${benchmark_src}/CMakeLists.txt")
+
+if(NOT EXISTS "${benchmark_bin}/Makefile")
+  if(JOBS)
+    set(benchmark_jobs "-DCMAKE_DEPENDS_SCAN_JOBS:STRING=${JOBS}")
+  else(JOBS)
+    set(benchmark_jobs)
+  endif(JOBS)
+  file(MAKE_DIRECTORY "${benchmark_bin}")
+  execute_process(
+    COMMAND ${CMAKE_COMMAND} -G "Unix Makefiles" ${benchmark_jobs}
+      "${benchmark_src}"
+    WORKING_DIRECTORY "${benchmark_bin}"
+    RESULT_VARIABLE benchmark_result
+    OUTPUT_QUIET
+    )
+  if(benchmark_result)
+    message(FATAL_ERROR "configuring ${benchmark_src} failed")
+  endif(benchmark_result)
+endif(NOT EXISTS "${benchmark_bin}/Makefile")
+
+set(benchmark_target "${benchmark_bin}/CMakeFiles/DependScan.dir")
+foreach(i RANGE 1 ${SCANS})
+  # Without these files nothing is known about previous scans.
+  file(REMOVE
+    "${benchmark_target}/depend.internal"
+    "${benchmark_target}/depend.make"
+    "${benchmark_target}/C.includecache"
+    )
+  execute_process(
+    COMMAND ${CMAKE_COMMAND} -E cmake_depends "Unix Makefiles"
+      "${benchmark_src}" "${benchmark_src}"
+      "${benchmark_bin}" "${benchmark_bin}"
+      "${benchmark_target}/DependInfo.cmake"
+    RESULT_VARIABLE benchmark_result
+    OUTPUT_QUIET
+    )
+  if(benchmark_result)
+    message(FATAL_ERROR "scanning dependencies failed")
+  endif(benchmark_result)
+endforeach(i)
+
+file(STRINGS "${benchmark_target}/depend.internal" benchmark_lines)
+list(LENGTH benchmark_lines benchmark_count)
+message(STATUS "${SCANS} scans of ${SOURCES} sources and ${HEADERS} headers, "
+  "${benchmark_count} lines of dependencies")
@@ -0,0 +1,26 @@
+# Pushing and popping the variable scope of a function() call while
+# VARIABLES variables are defined, as in a large project.  A small
+# function is called CALLS times.
+
+get_filename_component(benchmark_list_dir "${CMAKE_CURRENT_LIST_FILE}" PATH)
+include("${benchmark_list_dir}/Parameters.cmake")
+benchmark_parameter(VARIABLES 8000)
+benchmark_parameter(CALLS 100000)
+
+foreach(i RANGE ${VARIABLES})
+  set(benchmark_var_${i} "value ${i}")
+endforeach(i)
+
+function(benchmark_helper arg)
+  set(local "${arg} ${benchmark_var_1}")
+  set(benchmark_result "${local}" PARENT_SCOPE)
+endfunction(benchmark_helper)
+
+foreach(i RANGE 1 ${CALLS})
+  benchmark_helper(${i})
+endforeach(i)
+
+if(NOT "${benchmark_result}" STREQUAL "${CALLS} value 1")
+  message(FATAL_ERROR "unexpected result \"${benchmark_result}\"")
+endif(NOT "${benchmark_result}" STREQUAL "${CALLS} value 1")
+message(STATUS "${CALLS} calls with ${VARIABLES} variables defined")
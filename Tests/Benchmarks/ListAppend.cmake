@@ -0,0 +1,31 @@
+# Growing a list with list(APPEND) and list(LENGTH) and walking it
+# with foreach(IN LISTS).  FILES source names are appended one at a
+# time.  When each step split the whole list again, the time grew with
+# the square of FILES.
+
+get_filename_component(benchmark_list_dir "${CMAKE_CURRENT_LIST_FILE}" PATH)
+include("${benchmark_list_dir}/Parameters.cmake")
+benchmark_parameter(FILES 50000)
+
+set(benchmark_sources)
+foreach(i RANGE 1 ${FILES})
+  list(APPEND benchmark_sources "${CMAKE_CURRENT_SOURCE_DIR}/src/file${i}.cxx")
+  list(LENGTH benchmark_sources benchmark_length)
+endforeach(i)
+
+set(benchmark_count 0)
+foreach(src IN LISTS benchmark_sources)
+  math(EXPR benchmark_count "${benchmark_count} + 1")
+endforeach(src)
+
+if(NOT benchmark_length EQUAL FILES)
+  message(FATAL_ERROR "unexpected length ${benchmark_length}")
+endif(NOT benchmark_length EQUAL FILES)
+if(NOT benchmark_count EQUAL FILES)
+  message(FATAL_ERROR "unexpected count ${benchmark_count}")
+endif(NOT benchmark_count EQUAL FILES)
+list(GET benchmark_sources -1 benchmark_last)
+if(NOT benchmark_last MATCHES "/file${FILES}[.]cxx$")
+  message(FATAL_ERROR "unexpected last element ${benchmark_last}")
+endif(NOT benchmark_last MATCHES "/file${FILES}[.]cxx$")
+message(STATUS "${FILES} sources appended")
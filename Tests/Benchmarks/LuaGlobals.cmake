@@ -0,0 +1,49 @@
+# Reading Lua globals from a CMakeLists.lua: standard library tables,
+# builtin functions and a function the listfile defined itself.  A
+# project whose listfile makes LOOKUPS rounds of such reads is
+# configured once.  The listfile prints the time its loop took.
+
+get_filename_component(benchmark_list_dir "${CMAKE_CURRENT_LIST_FILE}" PATH)
+include("${benchmark_list_dir}/Parameters.cmake")
+benchmark_parameter(LOOKUPS 2000000)
+
+set(benchmark_dir "${CMAKE_CURRENT_BINARY_DIR}/LuaGlobals-${LOOKUPS}")
+set(benchmark_src "${benchmark_dir}/src")
+set(benchmark_bin "${benchmark_dir}/bin")
+
+file(WRITE "${benchmark_src}/CMakeLists.lua" "
+cmake.project('LuaGlobals', 'NONE')
+
+function benchmark_step(x) return x + 1 end
+
+local start = os.clock()
+local total = 0
+for i = 1, ${LOOKUPS} do
+  total = benchmark_step(total) + math.floor(string.len('') / 2)
+  if type(ipairs) ~= 'function' then
+    error('ipairs is not a function')
+  end
+end
+if total ~= ${LOOKUPS} then
+  error('unexpected result ' .. total)
+end
+print(string.format('-- ${LOOKUPS} rounds of global reads: %.3f s',
+                    os.clock() - start))
+")
+
+file(REMOVE_RECURSE "${benchmark_bin}")
+file(MAKE_DIRECTORY "${benchmark_bin}")
+execute_process(
+  COMMAND ${CMAKE_COMMAND} -G "Unix Makefiles" "${benchmark_src}"
+  WORKING_DIRECTORY "${benchmark_bin}"
+  RESULT_VARIABLE benchmark_result
+  OUTPUT_VARIABLE benchmark_output
+  ERROR_VARIABLE benchmark_output
+  )
+if(benchmark_result)
+  message(FATAL_ERROR "configuring ${benchmark_src} failed:\n"
+    "${benchmark_output}")
+endif(benchmark_result)
+string(REGEX MATCH "[0-9]+ rounds of global reads: [0-9.]+ s"
+  benchmark_time "${benchmark_output}")
+message(STATUS "${benchmark_time}")
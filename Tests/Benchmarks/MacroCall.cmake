@@ -0,0 +1,31 @@
+# Binding the arguments of a macro() call into its body.  The macro has
+# eight formal parameters and its body refers to each of them and to
+# ARGC, ARGN, ARGV and ARGVn.  It is called CALLS times.
+
+get_filename_component(benchmark_list_dir "${CMAKE_CURRENT_LIST_FILE}" PATH)
+include("${benchmark_list_dir}/Parameters.cmake")
+benchmark_parameter(CALLS 20000)
+
+macro(benchmark_macro a b c d e f g h)
+  set(benchmark_args "${a}-${b}-${c}-${d}" "${e}-${f}-${g}-${h}")
+  set(benchmark_count "${ARGC}:${ARGV0}:${ARGV9}")
+  set(benchmark_rest ${ARGN})
+  set(benchmark_all "${ARGV}")
+  set(benchmark_unchanged "literal text without references")
+endmacro(benchmark_macro)
+
+foreach(i RANGE 1 ${CALLS})
+  benchmark_macro(${i} b c d e f g h extra1 extra2)
+endforeach(i)
+
+set(expect "${CALLS}-b-c-d;e-f-g-h")
+if(NOT "${benchmark_args}" STREQUAL "${expect}")
+  message(FATAL_ERROR "unexpected arguments \"${benchmark_args}\"")
+endif(NOT "${benchmark_args}" STREQUAL "${expect}")
+if(NOT "${benchmark_count}" STREQUAL "10:${CALLS}:extra2")
+  message(FATAL_ERROR "unexpected count \"${benchmark_count}\"")
+endif(NOT "${benchmark_count}" STREQUAL "10:${CALLS}:extra2")
+if(NOT "${benchmark_rest}" STREQUAL "extra1;extra2")
+  message(FATAL_ERROR "unexpected ARGN \"${benchmark_rest}\"")
+endif(NOT "${benchmark_rest}" STREQUAL "extra1;extra2")
+message(STATUS "${CALLS} macro calls")
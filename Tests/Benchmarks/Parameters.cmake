@@ -0,0 +1,8 @@
+# Included by the benchmarks to give their parameters defaults.
+
+# Set the variable NAME to DEFAULT unless it is set on the command line.
+macro(benchmark_parameter name default)
+  if(NOT ${name})
+    set(${name} ${default})
+  endif(NOT ${name})
+endmacro(benchmark_parameter)
@@ -0,0 +1,28 @@
+# Matching the same few patterns over and over with if(MATCHES) and
+# string(REGEX), as find modules do when they parse versions and file
+# names, ITERATIONS times.  With --profile the summary should show a
+# hit rate of the pattern cache close to 100%.
+
+get_filename_component(benchmark_list_dir "${CMAKE_CURRENT_LIST_FILE}" PATH)
+include("${benchmark_list_dir}/Parameters.cmake")
+benchmark_parameter(ITERATIONS 20000)
+
+set(benchmark_sources 0)
+set(benchmark_version)
+foreach(i RANGE 1 ${ITERATIONS})
+  set(name "src/module${i}/file_${i}.cxx")
+  if(name MATCHES "^src/([a-z]+)[0-9]+/[a-z_0-9]+\\.(c|cc|cxx|cpp)$")
+    math(EXPR benchmark_sources "${benchmark_sources} + 1")
+  endif(name MATCHES "^src/([a-z]+)[0-9]+/[a-z_0-9]+\\.(c|cc|cxx|cpp)$")
+  string(REGEX REPLACE "^([0-9]+)\\.([0-9]+)\\.([0-9]+)$" "\\3.\\2.\\1"
+    benchmark_version "1.2.${i}")
+  string(REGEX MATCH "[0-9]+" benchmark_number "${name}")
+endforeach(i)
+
+if(NOT benchmark_sources EQUAL ITERATIONS)
+  message(FATAL_ERROR "unexpected match count ${benchmark_sources}")
+endif(NOT benchmark_sources EQUAL ITERATIONS)
+if(NOT "${benchmark_version}" STREQUAL "${ITERATIONS}.2.1")
+  message(FATAL_ERROR "unexpected version ${benchmark_version}")
+endif(NOT "${benchmark_version}" STREQUAL "${ITERATIONS}.2.1")
+message(STATUS "${ITERATIONS} iterations")
@@ -0,0 +1,82 @@
+# Commands redefined after calls to them were resolved.  A call keeps
+# the command its name resolved to only until the command table
+# changes, in a loop body, a macro body or a function body alike.
+# CommandCacheTest runs this with and without CMAKE_COMPILE_LISTFILES.
+set(trace "")
+
+# A call in a loop body, with the command redefined after it ran.
+function(greet)
+  set(trace "${trace}[one]" PARENT_SCOPE)
+endfunction(greet)
+foreach(i 1 2)
+  greet()
+  function(greet)
+    set(trace "${trace}[two]" PARENT_SCOPE)
+  endfunction(greet)
+endforeach(i)
+
+# A call in a macro body and in a function body.
+macro(greet_from_macro)
+  greet()
+endmacro(greet_from_macro)
+function(greet_from_function)
+  greet()
+  set(trace "${trace}" PARENT_SCOPE)
+endfunction(greet_from_function)
+greet_from_macro()
+greet_from_function()
+function(greet)
+  set(trace "${trace}[three]" PARENT_SCOPE)
+endfunction(greet)
+greet_from_macro()
+greet_from_function()
+
+# A builtin replaced by a macro.  The builtin stays reachable under
+# its new name.
+foreach(i 1 2)
+  get_filename_component(name /a/b/c${i}.txt NAME)
+  set(trace "${trace}[${name}]")
+  if(i EQUAL 1)
+    macro(get_filename_component var)
+      set(${var} "replaced")
+    endmacro(get_filename_component)
+  endif(i EQUAL 1)
+endforeach(i)
+_get_filename_component(name /a/b/d.txt NAME)
+set(trace "${trace}[${name}]")
+
+# A function that replaces itself twice while it runs.  The second
+# definition frees the prototype of the running one.
+function(mutate)
+  function(mutate)
+    set(trace "${trace}[mutated]" PARENT_SCOPE)
+  endfunction(mutate)
+  function(mutate)
+    set(trace "${trace}[mutated again]" PARENT_SCOPE)
+  endfunction(mutate)
+  set(trace "${trace}[original]" PARENT_SCOPE)
+endfunction(mutate)
+mutate()
+mutate()
+
+# Recursion runs the same reusable commands while earlier calls of
+# them have not returned.
+function(count_up n)
+  if(n GREATER 0)
+    math(EXPR m "${n} - 1")
+    count_up(${m})
+  else(n GREATER 0)
+    set(out "")
+  endif(n GREATER 0)
+  set(out "${out}${n}" PARENT_SCOPE)
+endfunction(count_up)
+count_up(5)
+set(trace "${trace}[${out}]")
+
+set(expected "[one][two][two][two][three][three]")
+set(expected "${expected}[c1.txt][replaced][d.txt]")
+set(expected "${expected}[original][mutated again][012345]")
+if(NOT "${trace}" STREQUAL "${expected}")
+  message(FATAL_ERROR "CMAKE_COMPILE_LISTFILES=${CMAKE_COMPILE_LISTFILES} "
+    "produced\n  ${trace}\ninstead of\n  ${expected}")
+endif(NOT "${trace}" STREQUAL "${expected}")
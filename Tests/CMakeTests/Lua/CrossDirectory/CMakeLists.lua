@@ -0,0 +1,15 @@
+-- A helper defined here and called from the subdirectory must act on
+-- the subdirectory.
+cmake.project("CrossDirectory", "NONE")
+
+function record_directory(name)
+	cmake.set(name, cmake.vars.CMAKE_CURRENT_SOURCE_DIR)
+	cmake.add_custom_target(name)
+end
+
+record_directory("in_top")
+cmake.add_subdirectory("sub")
+
+if cmake.vars.in_sub ~= nil then
+	cmake.message("SEND_ERROR", "the helper set in_sub in the top directory")
+end
@@ -0,0 +1,5 @@
+record_directory("in_sub")
+if cmake.vars.in_sub ~= cmake.vars.CMAKE_CURRENT_SOURCE_DIR then
+	cmake.message("SEND_ERROR", "the helper ran in " ..
+	              tostring(cmake.vars.in_sub))
+end
@@ -0,0 +1,2 @@
+# Like many find modules, set only the upper-case result variable.
+set(UPPERCASE_FOUND TRUE)
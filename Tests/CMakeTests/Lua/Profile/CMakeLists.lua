@@ -0,0 +1,16 @@
+-- Every closure made by the loop comes from one definition and must be
+-- reported as one function.
+cmake.project("Profile", "NONE")
+
+local total = 0
+for i = 1, 100 do
+	local add_index = function(x) return x + i end
+	total = add_index(total)
+end
+
+-- Two functions defined on one line are reported apart.
+local twice, half = function(x) return x * 2 end, function(x) return x / 2 end
+for i = 1, 3 do total = twice(total) end
+for i = 1, 5 do total = half(total) end
+
+cmake.set("profile_total", math.floor(total))
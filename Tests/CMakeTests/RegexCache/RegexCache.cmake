@@ -0,0 +1,39 @@
+# Fill the regular expression cache, use its oldest pattern again and
+# add more.  The least recently used patterns must be evicted and
+# compiled again when they come back.  Results are checked with
+# STREQUAL only, so these are the only patterns compiled: 258 misses,
+# 3 hits and 2 evictions.  RegexCacheTest checks the counts in the
+# --profile summary.
+
+# CM_REGULAR_EXPRESSION_CACHE_SIZE
+set(size 256)
+
+# A pattern compiled for another number does not match and leaves the
+# input unchanged.
+macro(check_pattern i)
+  string(REGEX REPLACE "^p-${i}-([a-z]+)$" "\\1-${i}" result "p-${i}-abc")
+  if(NOT "${result}" STREQUAL "abc-${i}")
+    message(FATAL_ERROR "pattern ${i} replaced to \"${result}\"")
+  endif(NOT "${result}" STREQUAL "abc-${i}")
+endmacro(check_pattern)
+
+math(EXPR last "${size} - 1")
+foreach(i RANGE ${last})
+  check_pattern(${i})
+endforeach(i)
+
+# Pattern 0 is now the most recently used, so adding pattern 256
+# evicts pattern 1.
+if("p-0-xyz" MATCHES "^p-0-([a-z]+)$")
+  if(NOT "${CMAKE_MATCH_1}" STREQUAL "xyz")
+    message(FATAL_ERROR "pattern 0 matched \"${CMAKE_MATCH_1}\"")
+  endif(NOT "${CMAKE_MATCH_1}" STREQUAL "xyz")
+else("p-0-xyz" MATCHES "^p-0-([a-z]+)$")
+  message(FATAL_ERROR "pattern 0 did not match")
+endif("p-0-xyz" MATCHES "^p-0-([a-z]+)$")
+check_pattern(${size})
+check_pattern(0)
+
+# Pattern 1 is compiled again, evicting pattern 2.
+check_pattern(1)
+check_pattern(1)